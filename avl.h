@@ -1,62 +1,135 @@
 #pragma once
 // Filename: avl.h
-// 
-// Header file for the class AVL that represents an AVL tree
-// 
+//
+// Header file for the class template AVL that represents an AVL tree (namespace avl). Keys are ordered by Compare,
+// each node can carry a Value payload, and every node keeps the size and payload sum of its rooted subtree so
+// range counts and range sums take O(log n). Member definitions live in avl.tpp
+//
 // C. Seshadhri, Jan 2020
-// 
+//
 // Nick Kornienko Nov 2020
 
 #ifndef AVL_H
 #define AVL_H
 
+#include "avlstats.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 
 using namespace std;
 
+// lets an empty payload take no space in a node
+#ifdef _MSC_VER
+#define AVL_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define AVL_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+namespace avl
+{
+
+// empty payload for trees that only count keys
+struct NoValue
+{
+};
+
+inline NoValue operator+(NoValue, NoValue)
+{
+	return NoValue();
+}
+
 // node struct to hold data
+template <class Key, class Value>
 class Node
 {
 public:
-	string key;
+	Key key;
+	AVL_NO_UNIQUE_ADDRESS Value value, subtreeValue; // payload, and sum of payloads in the rooted subtree (including this node)
 	int height, subtreeSize;
 	Node* left, * right, * parent;
 
-	Node() // default constructor
-	{
-		height = 0;
-		subtreeSize = 0;
-		left = right = parent = NULL; // setting everything to NULL
-	}
-
-	Node(string val) // constructor that sets key to val
+	Node(const Key& val, const Value& weight) // constructor that sets key to val and payload to weight
+		: key(val), value(weight), subtreeValue(weight)
 	{
-		key = val;
 		height = 1;
 		subtreeSize = 0;
 		left = right = parent = NULL; // setting everything to NULL
 	}
 };
 
+template <class Key, class Value = NoValue, class Compare = less<Key>, class Alloc = allocator<Key> >
 class AVL
 {
+public:
+	typedef avl::Node<Key, Value> Node;
 private:
+	typedef typename allocator_traits<Alloc>::template rebind_alloc<Node> NodeAlloc;
+	typedef allocator_traits<NodeAlloc> NodeTraits;
+
 	Node* root; // Stores root of tree
+	Compare comp; // key order
+	NodeAlloc alloc; // allocator for nodes
 
 	Node* rotateLeft(Node*); // left rotation utility
 	Node* rotateRight(Node*); // right rotation utility
 	int height(Node*); // height utility to prevent nullptr
 	int balance(Node*); // balance utility
 	int subTree(Node*); // subtreeSize utility to prevent nullptr
+	Value subTreeValue(Node*); // subtreeValue utility to prevent nullptr
+	template <class A, class B> bool keyLess(const A&, const B&); // key comparison, counted in instrumented builds
+
+	Node* insert(Node*, Node*, Node*); // recursive version that links an already built node
+	template <class K1, class K2> void range(Node*, const K1&, const K2&, int&, Value&); // recursive workhorse for range and rangeSum
+	template <class K> void countAtLeast(Node*, const K&, int&, Value&); // count and sum of keys >= str in a rooted subtree
+	template <class K> void countAtMost(Node*, const K&, int&, Value&); // count and sum of keys <= str in a rooted subtree
+	template <class K1, class K2> int rangeCount(const K1&, const K2&, Value*); // instrumented entry point shared by range and rangeSum
+
+#ifdef AVL_STATS
+	AVLStats counters; // running totals, copied out by stats()
+	unsigned long long opComparisons, opDepth; // comparisons and depth of the operation in progress
+#endif
 public:
 	AVL(); // Default constructor sets root to null
-	void insert(string); // insert string into list 
-	Node* insert(Node*, Node*, string); // recursive version that inserts a node
+	explicit AVL(const Compare&, const Alloc& = Alloc()); // empty tree with a given order and allocator
+	AVL(const AVL&) = delete; // nodes are owned by the tree
+	AVL& operator=(const AVL&) = delete;
+	~AVL(); // frees every node
+
+	void insert(const Key&, const Value& = Value()); // insert key (with payload) into the tree
 	string printPreOrder(); // Construct string with tree printed PreOrder
 	string printPreOrder(Node* start); // Construct string with rooted subtree printed PreOrder
+	void deleteAVL(); // deletes every node to prevent memory leaks, and frees memory
+	void deleteAVL(Node* start); // deletes every Node in subtree rooted at start to prevent memory leaks
+	int size(); // number of keys in the tree
+
+	int range(const Key&, const Key&); // finds the number of nodes between two values
+	Value rangeSum(const Key&, const Key&); // sum of the payloads of the nodes between two values
+
+	// heterogeneous versions, only available when Compare is transparent (e.g. less<>). The bounds are deduced
+	// separately, so e.g. range("a", "bb") compares the two literals directly
+	template <class K1, class K2, class C = Compare, class = typename C::is_transparent> int range(const K1&, const K2&);
+	template <class K1, class K2, class C = Compare, class = typename C::is_transparent> Value rangeSum(const K1&, const K2&);
 
-	int range(string, string); // finds the number of nodes between two values
-	int range(Node*, string, string); // recursive workhorse for range
+#ifdef AVL_STATS
+	AVLStats stats() const; // snapshot of the instrumentation counters
+	void resetStats(); // zero the instrumentation counters
+#endif
 };
 
-#endif
\ No newline at end of file
+} // namespace avl
+
+#include "avl.tpp"
+
+namespace avl
+{
+
+// common instantiations are compiled once in avl.cpp
+extern template class AVL<string>;
+extern template class AVL<uint64_t>;
+extern template class AVL<uint64_t, uint64_t>;
+
+} // namespace avl
+
+#endif
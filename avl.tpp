@@ -0,0 +1,459 @@
+// Filename: avl.tpp
+//
+// Contains the member definitions of the class template AVL which represents an AVL tree. Contains implementations
+// of insert, range and rangeSum. Included at the bottom of avl.h
+//
+// C. Seshadhri, Jan 2020
+//
+// Nick Kornienko Nov 2020
+
+#include "keystring.h"
+#include <algorithm>
+#include <string>
+#ifdef AVL_STATS
+#include <chrono>
+#endif
+
+using namespace std;
+
+namespace avl
+{
+
+#define AVL_TEMPLATE template <class Key, class Value, class Compare, class Alloc>
+#define AVL_CLASS AVL<Key, Value, Compare, Alloc>
+
+// rotate with left, return new root node
+AVL_TEMPLATE
+typename AVL_CLASS::Node* AVL_CLASS::rotateLeft(Node* node)
+{
+	// store some nodes
+	Node* temp = node->right;
+	Node* nodeParent = node->parent;
+	Node* tempLeft = temp->left;
+
+	// store sub-tree sizes
+	// subTree(node->left) + subTree(temp->left);
+	int nodeSize = (!node->left ? 0 : subTree(node->left) + 1) + (!temp->left ? 0 : subTree(temp->left) + 1); // subTree doesn't count itself :/
+	int tempSize = subTree(node);
+	Value tempValue = node->subtreeValue; // temp takes over the whole subtree
+
+	// rotate
+	node->right = temp->left;
+	temp->left = node;
+
+	// update parents
+	temp->parent = nodeParent;
+	node->parent = temp;
+	if (tempLeft)
+		tempLeft->parent = node;
+
+	// update subtree sizes and sums
+	node->subtreeSize = nodeSize;
+	temp->subtreeSize = tempSize;
+	node->subtreeValue = subTreeValue(node->left) + node->value + subTreeValue(node->right);
+	temp->subtreeValue = tempValue;
+
+	// update height
+	node->height = max(height(node->left), height(node->right)) + 1;
+	temp->height = max(height(temp->right), height(node)) + 1;
+
+	return temp;
+}
+
+// rotate with right, return new root node
+AVL_TEMPLATE
+typename AVL_CLASS::Node* AVL_CLASS::rotateRight(Node* node)
+{
+	// store some nodes
+	Node* temp = node->left;
+	Node* nodeParent = node->parent;
+	Node* tempRight = temp->right;
+
+	// store sub-tree sizes
+	// subTree(node->right) + subTree(temp->right);
+	int nodeSize = (!node->right ? 0 : subTree(node->right) + 1) + (!temp->right ? 0 : subTree(temp->right) + 1); // subTree doesn't count itself :/
+	int tempSize = subTree(node);
+	Value tempValue = node->subtreeValue; // temp takes over the whole subtree
+
+	// rotate
+	node->left = temp->right;
+	temp->right = node;
+
+	// update parents
+	temp->parent = nodeParent;
+	node->parent = temp;
+	if (tempRight)
+		tempRight->parent = node;
+
+	// update subtree sizes and sums
+	node->subtreeSize = nodeSize;
+	temp->subtreeSize = tempSize;
+	node->subtreeValue = subTreeValue(node->left) + node->value + subTreeValue(node->right);
+	temp->subtreeValue = tempValue;
+
+	// update height
+	node->height = max(height(node->left), height(node->right)) + 1;
+	temp->height = max(height(temp->left), height(node)) + 1;
+
+	return temp;
+}
+
+// returns the height or 0 if the node is null(prevents nullptr)
+AVL_TEMPLATE
+int AVL_CLASS::height(Node* node)
+{
+	return !node ? 0 : node->height;
+}
+
+// returns the balance factor of the node as an int
+AVL_TEMPLATE
+int AVL_CLASS::balance(Node* node)
+{
+	return !node ? 0 : height(node->left) - height(node->right);
+}
+
+// returns subtree size(prevents nullptr)
+AVL_TEMPLATE
+int AVL_CLASS::subTree(Node* node)
+{
+	return !node ? 0 : node->subtreeSize;
+}
+
+// returns subtree payload sum, or an empty Value for a null node(prevents nullptr)
+AVL_TEMPLATE
+Value AVL_CLASS::subTreeValue(Node* node)
+{
+	return !node ? Value() : node->subtreeValue;
+}
+
+// compares two keys, counting the comparison in instrumented builds
+AVL_TEMPLATE
+template <class A, class B>
+inline bool AVL_CLASS::keyLess(const A& a, const B& b)
+{
+	AVL_STAT(opComparisons++);
+	return comp(a, b);
+}
+
+// Default constructor sets root to null
+AVL_TEMPLATE
+AVL_CLASS::AVL()
+	: root(NULL), comp(), alloc()
+{
+	AVL_STAT(opComparisons = opDepth = 0);
+}
+
+// Constructor for an empty tree ordered by cmp, allocating nodes from a
+AVL_TEMPLATE
+AVL_CLASS::AVL(const Compare& cmp, const Alloc& a)
+	: root(NULL), comp(cmp), alloc(a)
+{
+	AVL_STAT(opComparisons = opDepth = 0);
+}
+
+// Destructor frees every node
+AVL_TEMPLATE
+AVL_CLASS::~AVL()
+{
+	deleteAVL();
+}
+
+#ifdef AVL_STATS
+// returns a copy of the counters collected so far
+AVL_TEMPLATE
+AVLStats AVL_CLASS::stats() const
+{
+	return counters;
+}
+
+// zeroes the counters
+AVL_TEMPLATE
+void AVL_CLASS::resetStats()
+{
+	counters.reset();
+}
+#endif
+
+// Insert(Key val, Value weight): Inserts val with payload weight into tree. Just calls the recursive function
+// Input: key to insert into the tree, and its payload
+// Output: Void, just inserts new Node
+AVL_TEMPLATE
+void AVL_CLASS::insert(const Key& val, const Value& weight)
+{
+#ifdef AVL_STATS
+	opComparisons = opDepth = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+#endif
+	// build the node before touching the tree, so a throwing allocator or Key/Value copy leaves the tree unchanged
+	Node* node = NodeTraits::allocate(alloc, 1);
+	try
+	{
+		NodeTraits::construct(alloc, node, val, weight);
+	}
+	catch (...)
+	{
+		NodeTraits::deallocate(alloc, node, 1);
+		throw;
+	}
+	AVL_STAT(counters.allocations++);
+
+	try
+	{
+		root = insert(root, nullptr, node); // make call to recursive insert, starting from root
+	}
+	catch (...) // a throwing comparison, the descent had not linked or changed anything yet
+	{
+		NodeTraits::destroy(alloc, node);
+		NodeTraits::deallocate(alloc, node, 1);
+		throw;
+	}
+#ifdef AVL_STATS
+	unsigned long long nanos = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+	counters.inserts++;
+	counters.insertComparisons += opComparisons;
+	counters.record(counters.insertComparisonHist, opComparisons);
+	counters.recordLatency(counters.insertLatencyHist, nanos);
+#endif
+	return;
+}
+
+// insert(Node* start, Node* parent, Node* node): Recursive insert that maintains a self-balancing tree. Only key
+// comparisons happen on the way down, subtree sizes and sums are updated on the way back up once node is linked
+// (payload addition is expected not to throw, as for arithmetic payloads)
+// Input: already built node to insert into the subtree
+// Output: Node* new root node
+AVL_TEMPLATE
+typename AVL_CLASS::Node* AVL_CLASS::insert(Node* start, Node* parent, Node* node)
+{
+	// base case, insert here
+	if (!start)
+	{
+		node->parent = parent;
+		AVL_STAT(counters.record(counters.depthHist, opDepth));
+		AVL_STAT(if (opDepth > counters.maxDepth) counters.maxDepth = opDepth);
+		return node;
+	}
+
+	AVL_STAT(opDepth++);
+
+	// inserted node has smaller key, insert in left sub-tree
+	if (keyLess(node->key, start->key))
+		start->left = insert(start->left, start, node);
+	// inserted node has larger key, insert in the right sub-tree
+	else
+		start->right = insert(start->right, start, node);
+
+	start->subtreeSize++; // node was inserted below here, increment subtree size along the path
+	start->subtreeValue = start->subtreeValue + node->value; // and add its payload to the subtree sum
+
+	start->height = max(height(start->left), height(start->right)) + 1; // update height
+
+	// rebalance if needed
+	if (balance(start) > 1)
+	{
+		if (balance(start->left) >= 0) // left left (decided by shape, equal keys can land on either side)
+		{
+			AVL_STAT(counters.rotationsLL++);
+			return rotateRight(start);
+		}
+		else // left right
+		{
+			AVL_STAT(counters.rotationsLR++);
+			start->left = rotateLeft(start->left);
+			return rotateRight(start);
+		}
+	}
+	if (balance(start) < -1)
+	{
+		if (balance(start->right) <= 0) // right right
+		{
+			AVL_STAT(counters.rotationsRR++);
+			return rotateLeft(start);
+		}
+		else // right left
+		{
+			AVL_STAT(counters.rotationsRL++);
+			start->right = rotateRight(start->right);
+			return rotateLeft(start);
+		}
+	}
+	return start;
+}
+
+// returns number of keys in the tree
+AVL_TEMPLATE
+int AVL_CLASS::size()
+{
+	return !root ? 0 : subTree(root) + 1;
+}
+
+// returns number of nodes between two keys
+AVL_TEMPLATE
+int AVL_CLASS::range(const Key& str1, const Key& str2)
+{
+	return rangeCount(str1, str2, NULL);
+}
+
+// returns the payload sum of the nodes between two keys
+AVL_TEMPLATE
+Value AVL_CLASS::rangeSum(const Key& str1, const Key& str2)
+{
+	Value sum = Value();
+	rangeCount(str1, str2, &sum);
+	return sum;
+}
+
+// heterogeneous range, the bounds are compared to keys directly without converting them to Key
+AVL_TEMPLATE
+template <class K1, class K2, class C, class>
+int AVL_CLASS::range(const K1& str1, const K2& str2)
+{
+	return rangeCount(str1, str2, NULL);
+}
+
+// heterogeneous rangeSum
+AVL_TEMPLATE
+template <class K1, class K2, class C, class>
+Value AVL_CLASS::rangeSum(const K1& str1, const K2& str2)
+{
+	Value sum = Value();
+	rangeCount(str1, str2, &sum);
+	return sum;
+}
+
+// counts (and sums, if sum is not null) the nodes between two keys, just calls its recursive function
+AVL_TEMPLATE
+template <class K1, class K2>
+int AVL_CLASS::rangeCount(const K1& str1, const K2& str2, Value* sum)
+{
+#ifdef AVL_STATS
+	opComparisons = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+#endif
+	int count = 0;
+	Value total = Value();
+	range(root, str1, str2, count, total);
+#ifdef AVL_STATS
+	unsigned long long nanos = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+	counters.ranges++;
+	counters.rangeComparisons += opComparisons;
+	counters.record(counters.rangeComparisonHist, opComparisons);
+	counters.recordLatency(counters.rangeLatencyHist, nanos);
+#endif
+	if (sum)
+		*sum = total;
+	return count;
+}
+
+// recursive workhorse, walks down to the first node inside [str1, str2] and then counts each side with whole subtrees
+AVL_TEMPLATE
+template <class K1, class K2>
+void AVL_CLASS::range(Node* node, const K1& str1, const K2& str2, int& count, Value& sum)
+{
+	// base case, no more nodes on this path
+	if (!node)
+		return;
+
+	if (keyLess(node->key, str1)) // go right
+		return range(node->right, str1, str2, count, sum);
+	if (keyLess(str2, node->key)) // go left
+		return range(node->left, str1, str2, count, sum);
+
+	// node is in range, so everything in its left sub-tree is <= str2 and everything in its right sub-tree is >= str1
+	count++;
+	sum = sum + node->value;
+	countAtLeast(node->left, str1, count, sum);
+	countAtMost(node->right, str2, count, sum);
+}
+
+// adds the count and payload sum of the nodes in the rooted subtree with key >= str
+AVL_TEMPLATE
+template <class K>
+void AVL_CLASS::countAtLeast(Node* node, const K& str, int& count, Value& sum)
+{
+	while (node)
+	{
+		if (keyLess(node->key, str)) // node and its left sub-tree are too small
+			node = node->right;
+		else // node and its whole right sub-tree count
+		{
+			count += 1 + (!node->right ? 0 : subTree(node->right) + 1);
+			sum = sum + node->value + subTreeValue(node->right);
+			node = node->left;
+		}
+	}
+}
+
+// adds the count and payload sum of the nodes in the rooted subtree with key <= str
+AVL_TEMPLATE
+template <class K>
+void AVL_CLASS::countAtMost(Node* node, const K& str, int& count, Value& sum)
+{
+	while (node)
+	{
+		if (keyLess(str, node->key)) // node and its right sub-tree are too large
+			node = node->left;
+		else // node and its whole left sub-tree count
+		{
+			count += 1 + (!node->left ? 0 : subTree(node->left) + 1);
+			sum = sum + node->value + subTreeValue(node->left);
+			node = node->right;
+		}
+	}
+}
+
+// Deletes every Node to prevent memory leaks.
+// Input: None
+// Output: Void, just deletes every Node of the tree
+AVL_TEMPLATE
+void AVL_CLASS::deleteAVL()
+{
+	deleteAVL(root);
+	root = NULL;
+}
+
+// Deletes every Node in subtree rooted at start to prevent memory leaks.
+// Input: Node* start
+// Output: Void, just deletes every Node of the subtree
+AVL_TEMPLATE
+void AVL_CLASS::deleteAVL(Node* start)
+{
+	if (start == NULL) // tree is already empty
+		return;
+	deleteAVL(start->left); // delete left subtree
+	deleteAVL(start->right); // delete right subtree
+	NodeTraits::destroy(alloc, start); // delete node itself
+	NodeTraits::deallocate(alloc, start, 1);
+}
+
+// Prints tree Preorder. Calls the recursive function from the root
+// Input: None
+// Output: string that has all elements of the tree pre order
+AVL_TEMPLATE
+string AVL_CLASS::printPreOrder()
+{
+	return printPreOrder(root);
+}
+
+// Prints rooted subtree tree preorder, by making recursive calls
+// Input: None
+// Output: string that has all elements of the rooted tree preorder
+AVL_TEMPLATE
+string AVL_CLASS::printPreOrder(Node* start)
+{
+	if (start == NULL) // base case
+		return ""; // return empty string
+	string leftpart = printPreOrder(start->left);
+	string rightpart = printPreOrder(start->right);
+	string output = keyString(start->key);
+	if (leftpart.length() != 0) // left part is empty
+		output = output + " " + leftpart; // append left part
+	if (rightpart.length() != 0) // right part in empty
+		output = output + " " + rightpart; // append right part
+	return output;
+}
+
+#undef AVL_CLASS
+#undef AVL_TEMPLATE
+
+} // namespace avl
@@ -0,0 +1,96 @@
+// Filename: avlstats.cpp
+//
+// Contains the class AVLStats, which holds the counters and histograms collected by an instrumented AVL tree
+//
+
+#include "avlstats.h"
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+namespace avl
+{
+
+// prints one histogram as a JSON array, dropping the trailing empty buckets
+static void printHist(ostringstream& out, const char* name, const unsigned long long* hist)
+{
+	int last = AVLStats::BUCKETS;
+	while (last > 0 && hist[last - 1] == 0) // find the last non-empty bucket
+		last--;
+
+	out << "\"" << name << "\": [";
+	for (int i = 0; i < last; i++)
+		out << (i ? ", " : "") << hist[i];
+	out << "]";
+}
+
+// Default constructor zeroes every counter
+AVLStats::AVLStats()
+{
+	reset();
+}
+
+// zeroes every counter and histogram
+void AVLStats::reset()
+{
+	inserts = ranges = 0;
+	insertComparisons = rangeComparisons = 0;
+	rotationsLL = rotationsLR = rotationsRR = rotationsRL = 0;
+	allocations = 0;
+	maxDepth = 0;
+	for (int i = 0; i < BUCKETS; i++)
+	{
+		insertComparisonHist[i] = rangeComparisonHist[i] = depthHist[i] = 0;
+		insertLatencyHist[i] = rangeLatencyHist[i] = 0;
+	}
+}
+
+// adds a sample to a linear histogram, anything past the end goes in the last bucket
+void AVLStats::record(unsigned long long* hist, unsigned long long value)
+{
+	hist[value < BUCKETS ? value : BUCKETS - 1]++;
+}
+
+// adds a latency sample to a log2 histogram, bucket i holds [2^i, 2^(i+1)) ns (0 ns goes in bucket 0)
+void AVLStats::recordLatency(unsigned long long* hist, unsigned long long nanos)
+{
+	int bucket = 0;
+	while (nanos > 1 && bucket < BUCKETS - 1)
+	{
+		nanos >>= 1;
+		bucket++;
+	}
+	hist[bucket]++;
+}
+
+// Dumps every counter as one JSON object
+// Input: None
+// Output: string with the JSON object
+string AVLStats::toJSON() const
+{
+	ostringstream out;
+	out << "{\n";
+	out << "  \"inserts\": " << inserts << ",\n";
+	out << "  \"ranges\": " << ranges << ",\n";
+	out << "  \"insertComparisons\": " << insertComparisons << ",\n";
+	out << "  \"rangeComparisons\": " << rangeComparisons << ",\n";
+	out << "  \"rotations\": {\"LL\": " << rotationsLL << ", \"LR\": " << rotationsLR
+		<< ", \"RR\": " << rotationsRR << ", \"RL\": " << rotationsRL << "},\n";
+	out << "  \"allocations\": " << allocations << ",\n";
+	out << "  \"maxDepth\": " << maxDepth << ",\n";
+	out << "  ";
+	printHist(out, "insertComparisonHist", insertComparisonHist);
+	out << ",\n  ";
+	printHist(out, "rangeComparisonHist", rangeComparisonHist);
+	out << ",\n  ";
+	printHist(out, "depthHist", depthHist);
+	out << ",\n  ";
+	printHist(out, "insertLatencyLog2NsHist", insertLatencyHist);
+	out << ",\n  ";
+	printHist(out, "rangeLatencyLog2NsHist", rangeLatencyHist);
+	out << "\n}\n";
+	return out.str();
+}
+
+} // namespace avl
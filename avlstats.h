@@ -0,0 +1,52 @@
+#pragma once
+// Filename: avlstats.h
+//
+// Header file for AVLStats, the hot-path counters kept by the AVL tree. Counting is only compiled in
+// when AVL_STATS is defined; otherwise every AVL_STAT hook expands to nothing and the tree is unchanged
+//
+
+#ifndef AVLSTATS_H
+#define AVLSTATS_H
+
+#include <string>
+
+using namespace std;
+
+// wraps a statement that should only run in instrumented builds
+#ifdef AVL_STATS
+#define AVL_STAT(stmt) stmt
+#else
+#define AVL_STAT(stmt)
+#endif
+
+namespace avl
+{
+
+// snapshot of the counters, copied out of the tree by AVL::stats()
+class AVLStats
+{
+public:
+	static const int BUCKETS = 64; // histogram buckets, the last bucket also holds everything larger
+
+	unsigned long long inserts, ranges; // operations performed
+	unsigned long long insertComparisons, rangeComparisons; // total key comparisons per operation type
+	unsigned long long rotationsLL, rotationsLR, rotationsRR, rotationsRL; // rebalances by case
+	unsigned long long allocations; // nodes allocated
+	unsigned long long maxDepth; // deepest insert descent seen
+
+	unsigned long long insertComparisonHist[BUCKETS]; // comparisons per insert, bucket i = i comparisons
+	unsigned long long rangeComparisonHist[BUCKETS]; // comparisons per range, bucket i = i comparisons
+	unsigned long long depthHist[BUCKETS]; // insert descent depth, bucket i = depth i
+	unsigned long long insertLatencyHist[BUCKETS]; // insert latency, bucket i = [2^i, 2^(i+1)) ns
+	unsigned long long rangeLatencyHist[BUCKETS]; // range latency, bucket i = [2^i, 2^(i+1)) ns
+
+	AVLStats(); // zeroes every counter
+	void reset(); // zeroes every counter
+	void record(unsigned long long* hist, unsigned long long value); // add a linear sample to a histogram
+	void recordLatency(unsigned long long* hist, unsigned long long nanos); // add a log2 sample to a histogram
+	string toJSON() const; // dump every counter as a JSON object
+};
+
+} // namespace avl
+
+#endif
@@ -0,0 +1,271 @@
+// Filename: benchmark.cpp
+//
+// Benchmark harness for the range counting engines. Generates deterministic workloads (uniform, Zipfian, sorted,
+// reverse sorted and clustered keys, with different insert/query mixes and range widths) and reports throughput,
+// p50/p99 latency and peak heap use for each workload and tree size.
+//
+// The BST drops duplicate keys while the AVL keeps them, so checksums only agree on workloads without repeats.
+// Usage: benchmark [--avl] [--avl64] [--bst] [n ...]   (n >= 1, defaults to every engine and n = 1000 10000)
+//
+
+#include "avl.h"
+#include "bst.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// one operation of a workload, either an insert of key or a range query [key, key2]. The numeric ids are the
+// same keys for the integer keyed engine
+struct Op
+{
+	bool insert;
+	string key, key2;
+	uint64_t id, id2;
+};
+
+// per engine adapters used by run()
+static const char* engineName(avl::AVL<string>&) { return "AVL"; }
+static void insert(avl::AVL<string>& tree, const Op& op) { tree.insert(op.key); }
+static int query(avl::AVL<string>& tree, const Op& op) { return tree.range(op.key, op.key2); }
+static void destroy(avl::AVL<string>& tree) { tree.deleteAVL(); }
+
+static const char* engineName(avl::AVL<uint64_t>&) { return "AVL64"; }
+static void insert(avl::AVL<uint64_t>& tree, const Op& op) { tree.insert(op.id); }
+static int query(avl::AVL<uint64_t>& tree, const Op& op) { return tree.range(op.id, op.id2); }
+static void destroy(avl::AVL<uint64_t>& tree) { tree.deleteAVL(); }
+
+static const char* engineName(bst::BST<string>&) { return "BST"; }
+static void insert(bst::BST<string>& tree, const Op& op) { tree.insert(op.key); }
+static int query(bst::BST<string>& tree, const Op& op) { return tree.countStr(op.key, op.key2); }
+static void destroy(bst::BST<string>& tree) { tree.deleteBST(); }
+
+// heap accounting, every allocation carries a header with its size so delete can subtract it
+static size_t heapCurrent = 0, heapPeak = 0;
+static const size_t HEADER = 16; // keeps the returned pointer 16 byte aligned
+
+void* operator new(size_t size)
+{
+	char* block = (char*)malloc(size + HEADER);
+	if (!block)
+		throw bad_alloc();
+	*(size_t*)block = size;
+	heapCurrent += size;
+	if (heapCurrent > heapPeak)
+		heapPeak = heapCurrent;
+	return block + HEADER;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	if (!ptr)
+		return;
+	char* block = (char*)ptr - HEADER;
+	heapCurrent -= *(size_t*)block;
+	free(block);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	operator delete(ptr);
+}
+
+enum Distribution { UNIFORM, ZIPF, SORTED, REVERSE, CLUSTERED };
+static const char* DIST_NAMES[] = { "uniform", "zipf", "sorted", "reverse", "clustered" };
+
+// fixed width keys so string order matches numeric order
+static string makeKey(unsigned long long id)
+{
+	char buf[24];
+	snprintf(buf, sizeof(buf), "%012llu", id);
+	return string(buf);
+}
+
+// deterministic key generator for one distribution over the id universe [0, universe)
+class KeyGen
+{
+private:
+	Distribution dist;
+	unsigned long long universe, next;
+	mt19937_64 rng;
+	vector<double> zipfCdf; // cumulative probabilities of the Zipf ranks
+	vector<unsigned long long> centers; // cluster centers
+public:
+	KeyGen(Distribution d, unsigned long long u, unsigned long long seed) : dist(d), universe(u), next(0), rng(seed)
+	{
+		if (dist == ZIPF) // s = 1 over 'universe' ranks
+		{
+			zipfCdf.resize(universe);
+			double sum = 0;
+			for (unsigned long long i = 0; i < universe; i++)
+				zipfCdf[i] = (sum += 1.0 / (i + 1));
+			for (unsigned long long i = 0; i < universe; i++)
+				zipfCdf[i] /= sum;
+		}
+		if (dist == CLUSTERED) // a handful of dense regions
+			for (int i = 0; i < 16; i++)
+				centers.push_back(rng() % universe);
+	}
+
+	unsigned long long id()
+	{
+		switch (dist)
+		{
+		case ZIPF:
+		{
+			double p = uniform_real_distribution<double>(0, 1)(rng);
+			unsigned long long rank = lower_bound(zipfCdf.begin(), zipfCdf.end(), p) - zipfCdf.begin();
+			return (rank * 2654435761ULL) % universe; // scatter the hot ranks over the key space
+		}
+		case SORTED:
+			return (next++ * 2) % universe;
+		case REVERSE:
+			return universe - 1 - (next++ * 2) % universe;
+		case CLUSTERED:
+		{
+			long long offset = (long long)normal_distribution<double>(0, universe / 1000.0 + 1)(rng);
+			long long id = (long long)centers[rng() % centers.size()] + offset;
+			return id < 0 ? 0 : (unsigned long long)id % universe;
+		}
+		default:
+			return rng() % universe;
+		}
+	}
+};
+
+// generates n preload inserts followed by n mixed operations
+static vector<Op> makeWorkload(Distribution dist, size_t n, double insertFraction, double width, unsigned long long seed)
+{
+	unsigned long long universe = n * 4;
+	KeyGen keys(dist, universe, seed);
+	mt19937_64 rng(seed ^ 0x9e3779b97f4a7c15ULL);
+	unsigned long long span = (unsigned long long)(width * universe);
+
+	vector<Op> ops;
+	ops.reserve(2 * n);
+	for (size_t i = 0; i < n; i++)
+	{
+		uint64_t id = keys.id();
+		ops.push_back(Op{ true, makeKey(id), "", id, 0 });
+	}
+	for (size_t i = 0; i < n; i++)
+	{
+		if (uniform_real_distribution<double>(0, 1)(rng) < insertFraction)
+		{
+			uint64_t id = keys.id();
+			ops.push_back(Op{ true, makeKey(id), "", id, 0 });
+		}
+		else
+		{
+			uint64_t low = rng() % universe;
+			ops.push_back(Op{ false, makeKey(low), makeKey(low + span), low, low + span });
+		}
+	}
+	return ops;
+}
+
+// runs one workload against a fresh tree and prints a result row
+template <class Engine>
+static void run(const vector<Op>& ops, Distribution dist, size_t n, double insertFraction, double width)
+{
+	vector<long long> latencies;
+	latencies.reserve(n);
+
+	size_t heapBase = heapCurrent;
+	heapPeak = heapCurrent;
+	long long checksum = 0;
+	Engine tree;
+
+	// build phase
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (size_t i = 0; i < n; i++)
+		insert(tree, ops[i]);
+	double buildSecs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	// mixed phase, timing every operation
+	start = chrono::steady_clock::now();
+	for (size_t i = n; i < ops.size(); i++)
+	{
+		chrono::steady_clock::time_point opStart = chrono::steady_clock::now();
+		if (ops[i].insert)
+			insert(tree, ops[i]);
+		else
+			checksum += query(tree, ops[i]);
+		latencies.push_back(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - opStart).count());
+	}
+	double mixedSecs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	size_t peak = heapPeak - heapBase;
+
+	destroy(tree);
+
+	sort(latencies.begin(), latencies.end());
+	long long p50 = latencies[latencies.size() / 2];
+	long long p99 = latencies[min(latencies.size() - 1, latencies.size() * 99 / 100)];
+
+	printf("%-5s %-9s %8zu %6.2f %6.3f %12.0f %12.0f %9lld %9lld %12zu %14lld\n",
+		engineName(tree), DIST_NAMES[dist], n, insertFraction, width,
+		n / buildSecs, n / mixedSecs, p50, p99, peak, checksum);
+	fflush(stdout);
+}
+
+static int usage(const char* name)
+{
+	fprintf(stderr, "usage: %s [--avl] [--avl64] [--bst] [n ...]   (n >= 1, defaults to every engine and n = 1000 10000)\n", name);
+	return 1;
+}
+
+int main(int argc, char** argv)
+{
+	vector<size_t> sizes;
+	bool runAVL = false, runAVL64 = false, runBST = false;
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "--avl") // string keyed AVL
+			runAVL = true;
+		else if (arg == "--avl64") // integer keyed AVL
+			runAVL64 = true;
+		else if (arg == "--bst") // string keyed BST
+			runBST = true;
+		else
+		{
+			// anything else must be a tree size, unknown flags and typos are rejected instead of becoming n = 0
+			char* end;
+			unsigned long n = strtoul(argv[i], &end, 10);
+			if (arg.empty() || arg[0] == '-' || *end != '\0' || n == 0)
+				return usage(argv[0]);
+			sizes.push_back(n);
+		}
+	}
+	if (!runAVL && !runAVL64 && !runBST) // no engine picked, run them all
+		runAVL = runAVL64 = runBST = true;
+	if (sizes.empty())
+		sizes = { 1000, 10000 };
+
+	const double mixes[] = { 0.1, 0.5, 0.9 }; // fraction of mixed ops that are inserts
+	const double widths[] = { 0.001, 0.1 }; // range width as a fraction of the key universe
+
+	printf("%-5s %-9s %8s %6s %6s %12s %12s %9s %9s %12s %14s\n",
+		"eng", "dist", "n", "ins", "width", "build_op/s", "mixed_op/s", "p50_ns", "p99_ns", "peak_bytes", "checksum");
+	for (size_t n : sizes)
+		for (int dist = UNIFORM; dist <= CLUSTERED; dist++)
+			for (double mix : mixes)
+				for (double width : widths)
+				{
+					vector<Op> ops = makeWorkload((Distribution)dist, n, mix, width, 12345 + n);
+					if (runAVL)
+						run<avl::AVL<string> >(ops, (Distribution)dist, n, mix, width);
+					if (runAVL64)
+						run<avl::AVL<uint64_t> >(ops, (Distribution)dist, n, mix, width);
+					if (runBST)
+						run<bst::BST<string> >(ops, (Distribution)dist, n, mix, width);
+				}
+	return 0;
+}
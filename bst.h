@@ -1,22 +1,28 @@
 #pragma once
 // Filename: bst.h
 // 
-// Header file for the class BST that represents a binary search tree
+// Header file for the class template BST that represents a binary search tree (namespace bst). Keys are ordered by
+// Compare. Member definitions live in bst.tpp
 // 
 // C. Seshadhri, Jan 2020
 
 #ifndef BST_H
 #define BST_H
 
+#include <functional>
 #include <string>
 
 using namespace std;
 
+namespace bst
+{
+
 // node struct to hold data
+template <class Key>
 class Node
 {
 public:
-	string key;
+	Key key;
 	Node* left, * right, * parent;
 
 	Node() // default constructor
@@ -24,26 +30,31 @@ public:
 		left = right = parent = NULL; // setting everything to NULL
 	}
 
-	Node(string val) // constructor that sets key to val
+	Node(const Key& val) // constructor that sets key to val
+		: key(val)
 	{
-		key = val;
 		left = right = parent = NULL; // setting everything to NULL
 	}
 };
 
+template <class Key = string, class Compare = less<Key> >
 class BST
 {
+public:
+	typedef bst::Node<Key> Node;
 private:
 	Node* root; // Stores root of tree
+	Compare comp; // key order
 public:
 	BST(); // Default constructor sets root to null
-	void insert(string); // insert string into list 
+	explicit BST(const Compare&); // empty tree with a given order
+	void insert(const Key&); // insert key into tree, keys already present are ignored
 	void insert(Node*, Node*); // recursive version that inserts a node
-	Node* find(string); // find string in tree, and return pointer to node with that string. If there are multiple copies, this only finds one copy
-	Node* find(Node*, string); // recursive version that finds in a rooted subtree
+	Node* find(const Key&); // find string in tree, and return pointer to node with that string. If there are multiple copies, this only finds one copy
+	Node* find(Node*, const Key&); // recursive version that finds in a rooted subtree
 	Node* minNode(Node*); // gets minimum node in rooted subtree
 	Node* maxNode(Node*); // gets maximum node in rooted subtree
-	Node* deleteKey(string); // remove a node with string (if it exists), and return pointer to deleted node. This does not delete all nodes with the value.
+	Node* deleteKey(const Key&); // remove a node with string (if it exists), and return pointer to deleted node. This does not delete all nodes with the value.
 	Node* deleteNode(Node*); // try to delete node pointed by argument. This also returns the node, isolated from the tree.
 	void deleteBST(); // deletes every node to prevent memory leaks, and frees memory
 	void deleteBST(Node* start); // deletes every Node in subtree rooted at startto prevent memory leaks.
@@ -54,8 +65,20 @@ public:
 	string printPostOrder(); // Construct string with tree printed PostOrder
 	string printPostOrder(Node* start); // Construct string with rooted subtree printed PostOrder
 
-	int countStr(string, string); // Counts numbers of str between str1 and str2 by visitng each node and comparing against that node
-	int countStr(Node*, string, string); // recursive workhorse to count the number of nodes than are between str1 and str2
+	int countStr(const Key&, const Key&); // Counts numbers of str between str1 and str2 by visitng each node and comparing against that node
+	int countStr(Node*, const Key&, const Key&); // recursive workhorse to count the number of nodes than are between str1 and str2
 };
 
+} // namespace bst
+
+#include "bst.tpp"
+
+namespace bst
+{
+
+// the word instantiation is compiled once in bst.cpp
+extern template class BST<string>;
+
+} // namespace bst
+
 #endif
\ No newline at end of file
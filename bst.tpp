@@ -0,0 +1,365 @@
+// Filename: bst.tpp
+// 
+// Contains the member definitions of the class template BST that represents a binary search tree. This contains some basic operations, such as insert, delete, find, and printing in various traversal orders. Included at the bottom of bst.h
+// 
+// C. Seshadhri, Jan 2020
+
+#include "keystring.h"
+#include <string>
+
+using namespace std;
+
+namespace bst
+{
+
+#define BST_TEMPLATE template <class Key, class Compare>
+#define BST_CLASS BST<Key, Compare>
+
+// Default constructor sets head and tail to null
+BST_TEMPLATE
+BST_CLASS::BST()
+{
+	root = NULL;
+}
+
+// Constructor for an empty tree ordered by cmp
+BST_TEMPLATE
+BST_CLASS::BST(const Compare& cmp)
+	: comp(cmp)
+{
+	root = NULL;
+}
+
+// Insert(string val): Inserts the string val into tree, at the head of the list. Note that there may be multiple copies of val in the list. Just calls the recursive function
+// Input: string to insert into the BST
+// Output: Void, just inserts new Node
+BST_TEMPLATE
+void BST_CLASS::insert(const Key& val)
+{
+	Node* to_insert = new Node(val); // create a new Node with the value val
+	if (root == NULL) // tree is currently empty
+		root = to_insert; // make new node the root
+	else
+		insert(root, to_insert); // make call to recursive insert, starting from root
+}
+
+// insert(Node* start, Node* to_insert): Inserts the Node to_insert into tree rooted at start. We will always call with start being non-null. Updated to avoid inserting duplicates (a duplicate to_insert is deleted)
+// Input: string to insert into the subtree
+// Output: Void, just inserts new Node
+BST_TEMPLATE
+void BST_CLASS::insert(Node* start, Node* to_insert)
+{
+	if (start == NULL) // in general, this should not happen. We never call insert from a null tree
+		return;
+
+	// do not insert duplicates, the caller allocated to_insert so free it here
+	if (!comp(to_insert->key, start->key) && !comp(start->key, to_insert->key))
+	{
+		delete to_insert;
+		return;
+	}
+
+	if (comp(to_insert->key, start->key)) // inserted node has smaller key, so go left
+	{
+		if (start->left == NULL)
+		{
+			start->left = to_insert; // make this node the left child
+			to_insert->parent = start; // set the parent pointer
+			return;
+		}
+		else // need to make recursive call
+		{
+			insert(start->left, to_insert);
+			return;
+		}
+	}
+	else // inserted node has larger key, so go right
+	{
+		if (start->right == NULL)
+		{
+			start->right = to_insert; // make this node the right child
+			to_insert->parent = start; // set the parent pointer
+			return;
+		}
+		else // need to make recursive call
+		{
+			insert(start->right, to_insert);
+			return;
+		}
+	}
+}
+
+// find(const Key& val): Finds a Node with key "val"
+// Input: string to be found
+// Output: a pointer to a Node containing val, if it exists. Otherwise, it returns NULL
+// Technically, it finds the first Node with val, at it traverses down the tree
+BST_TEMPLATE
+typename BST_CLASS::Node* BST_CLASS::find(const Key& val)
+{
+	return find(root, val); // call the recursive function starting at root
+}
+
+// find(Node* start, int val): Recursively tries to find a Node with key "val", in subtree rooted at val
+// Input: int to be found
+// Output: a pointer to a Node containing val, if it exists. Otherwise, it returns NULL
+// Technically, it finds the first Node with val, at it traverses down the tree
+BST_TEMPLATE
+typename BST_CLASS::Node* BST_CLASS::find(Node* start, const Key& val)
+{
+	if (start == NULL || (!comp(start->key, val) && !comp(val, start->key))) // tree is empty or we found val
+		return start;
+	if (comp(val, start->key)) // val is smaller, so go left
+		return find(start->left, val);
+	else // val is larger, so go right
+		return find(start->right, val);
+}
+
+// minNode(Node* start): gets the minimum Node in subtree rooted at start
+// Input: Pointer to subtree root
+// Output: pointer to the minimum node in the subtree
+BST_TEMPLATE
+typename BST_CLASS::Node* BST_CLASS::minNode(Node* start)
+{
+	if (start == NULL) // typically, this should not happen. But let's return the safe thing
+		return NULL;
+	if (start->left == NULL) // Base case: we have found the minimum
+		return start;
+	else
+		return minNode(start->left); // recursive call in left subtree
+}
+
+// maxNode(Node* start): gets the maximum Node in subtree rooted at start
+// Input: Pointer to subtree root
+// Output: pointer to the maximum node in the subtree
+BST_TEMPLATE
+typename BST_CLASS::Node* BST_CLASS::maxNode(Node* start)
+{
+	if (start == NULL) // typically, this should not happen. But let's return the safe thing
+		return NULL;
+	if (start->right == NULL) // Base case: we have found the maximum
+		return start;
+	else
+		return minNode(start->right); // recursive call in left subtree
+}
+
+// deleteNode(string val): Delete a Node with key val, if it exists. Otherwise, do nothing.
+// Input: string to be removed
+// Output: pointer to Node that was deleted. If no Node is deleted, return NULL. If there are multiple Nodes with val, only the first Node in the list is deleted.
+BST_TEMPLATE
+typename BST_CLASS::Node* BST_CLASS::deleteKey(const Key& val)
+{
+	return deleteNode(find(val)); // get a node with the value and delete that node
+}
+
+// deleteNode(Node* to_delete): Delete the input node, and return pointer to the deleted node. The node will be isolated from the tree, to prevent memory leaks
+// Input: Node to be removed
+// Output: pointer to Node that was deleted. If no Node is deleted, return NULL. 
+BST_TEMPLATE
+typename BST_CLASS::Node* BST_CLASS::deleteNode(Node* to_delete)
+{
+	if (to_delete == NULL) // val not present in tree, so return NULL
+		return NULL;
+
+	bool isRoot = (to_delete == root) ? true : false; // determine if node to delete is root
+	bool isLeftChild = false;
+	if (!isRoot) // if this is not the root
+		isLeftChild = (to_delete->parent->left == to_delete) ? true : false; // determine if node is left child of parent. Note that line throws error iff to_delete is root
+
+	bool isDeleted = false; // convenient flag for writing code
+
+	// if to_delete's left child is NULL, then we can splice this node off. We set the appropriate
+	// pointer of the parent to the right child of to_delete
+	if (to_delete->left == NULL)
+	{
+		//         cout << "left is null, isLeftChild is "+to_string(isLeftChild) << endl;
+		//         cout << "parent is "+to_string(to_delete->parent->key) << endl;
+		if (isRoot) // if deleting root, then we reset root
+		{
+			root = to_delete->right;
+			if (root != NULL)
+				root->parent = NULL; // set parent to be NULL
+		}
+		else
+		{
+			if (isLeftChild) // node is left child of parent
+				to_delete->parent->left = to_delete->right; // setting left child of parent to be right child of node
+			else // node is right child of parent
+				to_delete->parent->right = to_delete->right; // setting right child of parent to be right child of node
+			if (to_delete->right != NULL) // to_delete is not a leaf
+				to_delete->right->parent = to_delete->parent; // update parent of the child of the deleted node, to be parent of deleted node
+		}
+		isDeleted = true; // delete is done
+	}
+	// suppose node is not deleted yet, and it's right child is NULL. We splice off as before, by setting parent's child pointer to to_delete->left
+	if (!isDeleted && to_delete->right == NULL)
+	{
+		if (isRoot) // if deleting root, then we reset root
+		{
+			root = to_delete->left;
+			if (root != NULL)
+				root->parent = NULL; // set parent to be NULL
+		}
+		else
+		{
+			if (isLeftChild) // node is left child of parent
+				to_delete->parent->left = to_delete->left; // setting left child of parent to be left child of node
+			else // node is right child of parent
+				to_delete->parent->right = to_delete->left; // setting right child of parent to be left child of node
+			if (to_delete->left != NULL) // to delete is not a leaf
+				to_delete->left->parent = to_delete->parent; // update parent of the child of deleted node, to be parent of deleted node
+		}
+		isDeleted = true; // delete is done
+	}
+	if (isDeleted) // so node has been deleted
+	{
+		to_delete->left = to_delete->right = NULL;
+		return to_delete;
+	}
+
+	// phew. The splicing case is done, so now for the recursive case. Both children of to_delete are not null, so we replace the data in to_delete by the successor. Then we delete the successor node
+	// first, get the minimum node of right subtree
+	Node* succ = minNode(to_delete->right);
+	to_delete->key = succ->key;
+	//     cout << "Replacing with "+to_string(succ->key) << endl;
+	return deleteNode(succ); // make recursive call on succ. Note that succ has one null child, so this recursive call will terminate without any other recursive calls
+}
+
+
+// Deletes every Node to prevent memory leaks.
+// Input: None
+// Output: Void, just deletes every Node of the list
+BST_TEMPLATE
+void BST_CLASS::deleteBST()
+{
+	deleteBST(root);
+}
+
+// Deletes every Node in subtree rooted at startto prevent memory leaks.
+// Input: Node* start
+// Output: Void, just deletes every Node of the list
+BST_TEMPLATE
+void BST_CLASS::deleteBST(Node* start)
+{
+	if (start == NULL) // tree is already empty
+		return;
+	deleteBST(start->left); // delete left subtree
+	deleteBST(start->right); // delete right subtree
+	delete(start); // delete node itself
+}
+
+// Prints tree in order. Calls the recursive function from the root
+// Input: None
+// Output: string that has all elements of the tree in order
+BST_TEMPLATE
+string BST_CLASS::printInOrder()
+{
+	return printInOrder(root);
+}
+
+// Prints tree Preorder. Calls the recursive function from the root
+// Input: None
+// Output: string that has all elements of the tree pre order
+BST_TEMPLATE
+string BST_CLASS::printPreOrder()
+{
+	return printPreOrder(root);
+}
+
+// Prints tree Postorder. Calls the recursive function from the root
+// Input: None
+// Output: string that has all elements of the tree post order
+BST_TEMPLATE
+string BST_CLASS::printPostOrder()
+{
+	return printPostOrder(root);
+}
+
+// Prints rooted subtree tree in order, by making recursive calls
+// Input: None
+// Output: string that has all elements of the rooted tree in order
+BST_TEMPLATE
+string BST_CLASS::printInOrder(Node* start)
+{
+	if (start == NULL) // base case
+		return ""; // return empty string
+	string leftpart = printInOrder(start->left);
+	string rightpart = printInOrder(start->right);
+	string output = keyString(start->key);
+	if (leftpart.length() != 0) // left part is empty
+		output = leftpart + " " + output; // append left part
+	if (rightpart.length() != 0) // right part in empty
+		output = output + " " + rightpart; // append right part
+	return output;
+}
+
+// Prints rooted subtree tree preorder, by making recursive calls
+// Input: None
+// Output: string that has all elements of the rooted tree preorder
+BST_TEMPLATE
+string BST_CLASS::printPreOrder(Node* start)
+{
+	if (start == NULL) // base case
+		return ""; // return empty string
+	string leftpart = printPreOrder(start->left);
+	string rightpart = printPreOrder(start->right);
+	string output = keyString(start->key);
+	if (leftpart.length() != 0) // left part is empty
+		output = output + " " + leftpart; // append left part
+	if (rightpart.length() != 0) // right part in empty
+		output = output + " " + rightpart; // append right part
+	return output;
+}
+
+// Prints rooted subtree tree postorder, by making recursive calls
+// Input: None
+// Output: string that has all elements of the rooted tree in post order
+BST_TEMPLATE
+string BST_CLASS::printPostOrder(Node* start)
+{
+	if (start == NULL) // base case
+		return ""; // return empty string
+	string leftpart = printPostOrder(start->left);
+	string rightpart = printPostOrder(start->right);
+	string output = keyString(start->key);
+	if (rightpart.length() != 0) // right part is empty
+		output = rightpart + " " + output; // append left part
+	if (leftpart.length() != 0) // left part in empty
+		output = leftpart + " " + output; // append right part
+	return output;
+}
+
+// Counts numbers of str between str1 and str2 by visitng each node and comparing against that node
+BST_TEMPLATE
+int BST_CLASS::countStr(const Key& str1, const Key& str2)
+{
+	return countStr(root, str1, str2);
+}
+
+// recursively workhorse
+BST_TEMPLATE
+int BST_CLASS::countStr(Node* node, const Key& str1, const Key& str2)
+{
+	// base case
+	if (!node)
+		return 0;
+
+	// increment if the node is between the two given strings, then visit left and right children
+	if (!comp(node->key, str1) && !comp(str2, node->key))
+	{
+		return 1 +
+			countStr(node->left, str1, str2) +
+			countStr(node->right, str1, str2);
+	}
+
+	// visit right if node is less than str1
+	if (comp(node->key, str1))
+		return countStr(node->right, str1, str2);
+
+	// visit left if node is more than str2
+	return countStr(node->left, str1, str2);
+}
+
+#undef BST_CLASS
+#undef BST_TEMPLATE
+
+} // namespace bst
@@ -0,0 +1,72 @@
+#pragma once
+// Filename: check.h
+//
+// Scaffold shared by the brute force check programs registered with ctest: seed handling, random words, mismatch
+// reporting and the exit status. Each program runs its checks with the generator seeded by check::start and returns
+// check::finish
+//
+
+#ifndef CHECK_H
+#define CHECK_H
+
+#include "keystring.h"
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+using namespace std;
+
+namespace check
+{
+
+inline int failures = 0; // mismatches seen so far
+inline unsigned long long seed = 1; // seed of the current run, printed with the result
+
+// reads the optional seed argument and returns a generator seeded with it
+inline mt19937_64 start(int argc, char** argv)
+{
+	if (argc > 1)
+		seed = strtoull(argv[1], NULL, 10);
+	return mt19937_64(seed);
+}
+
+// "[low, high]" for a mismatch report
+template <class A, class B>
+string interval(const A& low, const B& high)
+{
+	return "[" + keyString(low) + ", " + keyString(high) + "]";
+}
+
+// reports one mismatch of the query described by where, only the first few are printed
+inline void mismatch(const string& what, const string& where, long long got, long long want)
+{
+	if (failures++ < 10)
+		fprintf(stderr, "%s%s%s: got %lld, want %lld\n", what.c_str(), where.empty() ? "" : " ", where.c_str(), got, want);
+}
+
+// random word of 1 to maxLength letters from the first letters of the alphabet, short words over a small alphabet
+// make queries hit plenty of keys and repeats common
+inline string randomWord(mt19937_64& rng, size_t maxLength, int letters)
+{
+	string word(1 + rng() % maxLength, 'a');
+	for (size_t i = 0; i < word.size(); i++)
+		word[i] = (char)('a' + rng() % letters);
+	return word;
+}
+
+// prints the result of the run, returns the exit code (1 on any mismatch)
+inline int finish(const char* program)
+{
+	if (failures)
+	{
+		fprintf(stderr, "%s: %d mismatches (seed %llu)\n", program, failures, seed);
+		return 1;
+	}
+	printf("%s: all answers match (seed %llu)\n", program, seed);
+	return 0;
+}
+
+} // namespace check
+
+#endif
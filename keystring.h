@@ -0,0 +1,30 @@
+#pragma once
+// Filename: keystring.h
+//
+// keyString(key), the key to text conversion shared by the print functions of the AVL and BST templates
+//
+
+#ifndef KEYSTRING_H
+#define KEYSTRING_H
+
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+// strings are used as is
+inline string keyString(const string& key)
+{
+	return key;
+}
+
+// any other key is formatted with operator<<
+template <class Key>
+string keyString(const Key& key)
+{
+	ostringstream out;
+	out << key;
+	return out.str();
+}
+
+#endif
@@ -0,0 +1,387 @@
+// Filename: rangecheck.cpp
+//
+// Brute force check of the range counting engines: random inserts interleaved with random queries, every answer of
+// AVL::range, AVL::rangeSum and BST::countStr is compared against a scan of the inserted keys. Also covers the AVL
+// template options (transparent and reversed comparators, a custom allocator) and inserts that fail part way through.
+// Built with AVL_STATS (WORDRANGE_STATS, and always as the rangecheck_stats target) it also checks the counters.
+// Registered with ctest.
+// Usage: rangecheck [seed]   (exit code 1 on any mismatch)
+//
+
+#include "avl.h"
+#include "bst.h"
+#include "check.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// string AVL (with repeated keys) and BST (which drops repeats) against a scan
+static void checkWords(mt19937_64& rng)
+{
+	avl::AVL<string> tree;
+	bst::BST<string> plain;
+	vector<string> words;
+	set<string> distinct;
+
+	for (int op = 0; op < 20000; op++)
+	{
+		if (rng() % 3 != 0) // insert
+		{
+			string word = check::randomWord(rng, 4, 6);
+			tree.insert(word);
+			plain.insert(word);
+			words.push_back(word);
+			distinct.insert(word);
+			continue;
+		}
+
+		string str1 = check::randomWord(rng, 4, 6), str2 = check::randomWord(rng, 4, 6);
+		if (rng() % 8 != 0 && str2 < str1) // mostly proper ranges, sometimes empty ones
+			swap(str1, str2);
+
+		long long want = 0;
+		for (size_t i = 0; i < words.size(); i++)
+			if (words[i] >= str1 && words[i] <= str2)
+				want++;
+		long long wantDistinct = 0;
+		for (set<string>::iterator it = distinct.begin(); it != distinct.end(); ++it)
+			if (*it >= str1 && *it <= str2)
+				wantDistinct++;
+
+		long long got = tree.range(str1, str2);
+		if (got != want)
+			check::mismatch("AVL<string>::range", check::interval(str1, str2), got, want);
+		got = plain.countStr(str1, str2);
+		if (got != wantDistinct)
+			check::mismatch("BST::countStr", check::interval(str1, str2), got, wantDistinct);
+	}
+	if (tree.size() != (int)words.size())
+		check::mismatch("AVL<string>::size", "", tree.size(), words.size());
+	plain.deleteBST();
+}
+
+// integer AVL with weights, checks both the count and the payload sum
+static void checkWeighted(mt19937_64& rng)
+{
+	avl::AVL<uint64_t, uint64_t> tree;
+	vector<pair<uint64_t, uint64_t> > points;
+
+	for (int op = 0; op < 20000; op++)
+	{
+		if (rng() % 3 != 0) // insert
+		{
+			uint64_t key = rng() % 5000, weight = rng() % 1000;
+			tree.insert(key, weight);
+			points.push_back(make_pair(key, weight));
+			continue;
+		}
+
+		uint64_t low = rng() % 5200, high = rng() % 5200;
+		if (rng() % 8 != 0 && high < low)
+			swap(low, high);
+
+		long long wantCount = 0, wantSum = 0;
+		for (size_t i = 0; i < points.size(); i++)
+			if (points[i].first >= low && points[i].first <= high)
+			{
+				wantCount++;
+				wantSum += points[i].second;
+			}
+
+		long long got = tree.range(low, high);
+		if (got != wantCount)
+			check::mismatch("AVL<uint64_t, uint64_t>::range", check::interval(low, high), got, wantCount);
+		got = (long long)tree.rangeSum(low, high);
+		if (got != wantSum)
+			check::mismatch("AVL<uint64_t, uint64_t>::rangeSum", check::interval(low, high), got, wantSum);
+	}
+}
+
+// string AVL with a transparent comparator, queried with bounds that are not strings
+static void checkTransparent(mt19937_64& rng)
+{
+	avl::AVL<string, avl::NoValue, less<> > tree;
+	vector<string> words;
+
+	for (int op = 0; op < 8000; op++)
+	{
+		if (rng() % 3 != 0) // insert
+		{
+			string word = check::randomWord(rng, 4, 6);
+			tree.insert(word);
+			words.push_back(word);
+			continue;
+		}
+
+		string str1 = check::randomWord(rng, 4, 6), str2 = check::randomWord(rng, 4, 6);
+		if (rng() % 8 != 0 && str2 < str1)
+			swap(str1, str2);
+
+		long long want = 0;
+		for (size_t i = 0; i < words.size(); i++)
+			if (words[i] >= str1 && words[i] <= str2)
+				want++;
+
+		// a different pair of bound types each time
+		long long got = rng() % 2 == 0 ? tree.range(string_view(str1), str2.c_str()) : tree.range(str1.c_str(), string_view(str2));
+		if (got != want)
+			check::mismatch("AVL<string, NoValue, less<>>::range(string_view/const char*)", check::interval(str1, str2), got, want);
+	}
+
+	// literals of different lengths deduce different array types
+	struct Literal { const char* str1; const char* str2; long long got; };
+	Literal literals[] = {
+		{ "a", "bb", tree.range("a", "bb") },
+		{ "ab", "f", tree.range("ab", "f") },
+		{ "ccc", "d", tree.range("ccc", "d") },
+		{ "b", "eeee", tree.range("b", string("eeee")) },
+	};
+	for (const Literal& literal : literals)
+	{
+		long long want = 0;
+		for (size_t i = 0; i < words.size(); i++)
+			if (words[i] >= literal.str1 && words[i] <= literal.str2)
+				want++;
+		if (literal.got != want)
+			check::mismatch("AVL<string, NoValue, less<>>::range(literals)", check::interval(literal.str1, literal.str2), literal.got, want);
+	}
+}
+
+// integer AVL ordered by greater<int>, so range(str1, str2) counts the keys from str1 down to str2, with signed weights
+static void checkReversed(mt19937_64& rng)
+{
+	avl::AVL<int, long, greater<int> > tree;
+	vector<pair<int, long> > points;
+
+	for (int op = 0; op < 20000; op++)
+	{
+		if (rng() % 3 != 0) // insert
+		{
+			int key = (int)(rng() % 1000) - 500;
+			long weight = (long)(rng() % 2000) - 1000;
+			tree.insert(key, weight);
+			points.push_back(make_pair(key, weight));
+			continue;
+		}
+
+		int str1 = (int)(rng() % 1040) - 520, str2 = (int)(rng() % 1040) - 520;
+		if (rng() % 8 != 0 && str1 < str2) // mostly proper ranges in the reversed order
+			swap(str1, str2);
+
+		long long wantCount = 0, wantSum = 0;
+		for (size_t i = 0; i < points.size(); i++)
+			if (points[i].first <= str1 && points[i].first >= str2)
+			{
+				wantCount++;
+				wantSum += points[i].second;
+			}
+
+		long long got = tree.range(str1, str2);
+		if (got != wantCount)
+			check::mismatch("AVL<int, long, greater<int>>::range", check::interval(str1, str2), got, wantCount);
+		got = tree.rangeSum(str1, str2);
+		if (got != wantSum)
+			check::mismatch("AVL<int, long, greater<int>>::rangeSum", check::interval(str1, str2), got, wantSum);
+	}
+}
+
+static long long comparisonBudget = -1; // comparisons ThrowingLess allows before throwing, -1 for no limit
+static bool failAllocation = false; // makes the next CountingAlloc::allocate throw
+static long long liveNodes = 0; // nodes allocated by CountingAlloc and not yet freed
+
+// int comparison that throws once comparisonBudget runs out
+struct ThrowingLess
+{
+	bool operator()(int a, int b) const
+	{
+		if (comparisonBudget == 0)
+			throw runtime_error("comparison budget spent");
+		if (comparisonBudget > 0)
+			comparisonBudget--;
+		return a < b;
+	}
+};
+
+// allocator that counts live nodes and fails on request
+template <class T>
+struct CountingAlloc
+{
+	typedef T value_type;
+
+	CountingAlloc() {}
+	template <class U> CountingAlloc(const CountingAlloc<U>&) {}
+
+	T* allocate(size_t n)
+	{
+		if (failAllocation)
+		{
+			failAllocation = false;
+			throw bad_alloc();
+		}
+		liveNodes += n;
+		return allocator<T>().allocate(n);
+	}
+
+	void deallocate(T* ptr, size_t n)
+	{
+		liveNodes -= n;
+		allocator<T>().deallocate(ptr, n);
+	}
+
+	template <class U> bool operator==(const CountingAlloc<U>&) const { return true; }
+	template <class U> bool operator!=(const CountingAlloc<U>&) const { return false; }
+};
+
+// inserts that throw part way through (in a comparison or in the allocator) must leave the tree as it was
+static void checkFailedInserts(mt19937_64& rng)
+{
+	{
+		avl::AVL<int, avl::NoValue, ThrowingLess, CountingAlloc<int> > tree;
+		vector<int> keys;
+		int failed = 0;
+
+		for (int op = 0; op < 5000; op++)
+		{
+			int key = (int)(rng() % 2000);
+			int size = tree.size(), all = tree.range(0, 2000);
+			long long live = liveNodes;
+
+			if (rng() % 4 == 0) // fail somewhere along the descent, or not at all if it is shorter
+				comparisonBudget = (long long)(rng() % 12);
+			else if (rng() % 8 == 0)
+				failAllocation = true;
+
+			bool threw = false;
+			try
+			{
+				tree.insert(key);
+				keys.push_back(key);
+			}
+			catch (const runtime_error&)
+			{
+				threw = true;
+			}
+			catch (const bad_alloc&)
+			{
+				threw = true;
+			}
+			comparisonBudget = -1;
+			failAllocation = false;
+
+			if (threw)
+			{
+				failed++;
+				if (tree.size() != size)
+					check::mismatch("failed AVL::insert size", check::interval(key, key), tree.size(), size);
+				if (tree.range(0, 2000) != all)
+					check::mismatch("failed AVL::insert range", check::interval(0, 2000), tree.range(0, 2000), all);
+				if (liveNodes != live)
+					check::mismatch("failed AVL::insert allocations", check::interval(key, key), liveNodes, live);
+			}
+			else if (liveNodes != live + 1)
+				check::mismatch("AVL::insert allocations", check::interval(key, key), liveNodes, live + 1);
+
+			// the tree must still answer correctly after any number of failed inserts
+			int str1 = (int)(rng() % 2000), str2 = (int)(rng() % 2000);
+			if (str2 < str1)
+				swap(str1, str2);
+			long long want = 0;
+			for (size_t i = 0; i < keys.size(); i++)
+				if (keys[i] >= str1 && keys[i] <= str2)
+					want++;
+			long long got = tree.range(str1, str2);
+			if (got != want)
+				check::mismatch("AVL::range after failed inserts", check::interval(str1, str2), got, want);
+		}
+		if (failed == 0)
+			check::mismatch("failed AVL::insert count", "", failed, 1);
+	}
+	if (liveNodes != 0) // the destructor returns every node to the allocator
+		check::mismatch("AVL::~AVL allocations", "", liveNodes, 0);
+}
+
+#ifdef AVL_STATS
+// sums a histogram of the instrumentation counters
+static unsigned long long histTotal(const unsigned long long* hist)
+{
+	unsigned long long total = 0;
+	for (int i = 0; i < avl::AVLStats::BUCKETS; i++)
+		total += hist[i];
+	return total;
+}
+
+// the instrumentation counters of a tree built from sorted keys must agree with the operations performed on it
+static void checkStats(mt19937_64& rng)
+{
+	avl::AVL<uint64_t, uint64_t> tree;
+	const int n = 4096, queries = 1000;
+	for (int i = 0; i < n; i++) // sorted input needs rotations all the way
+		tree.insert(i, rng() % 100);
+	for (int q = 0; q < queries; q++)
+	{
+		uint64_t low = rng() % n, high = low + rng() % 64;
+		if (q % 2 == 0)
+			tree.range(low, high);
+		else
+			tree.rangeSum(low, high);
+	}
+
+	avl::AVLStats stats = tree.stats();
+	if ((long long)stats.inserts != tree.size())
+		check::mismatch("AVLStats::inserts", "", stats.inserts, tree.size());
+	if (stats.allocations != stats.inserts)
+		check::mismatch("AVLStats::allocations", "", stats.allocations, stats.inserts);
+	if (stats.ranges != (unsigned long long)queries)
+		check::mismatch("AVLStats::ranges", "", stats.ranges, queries);
+	if (histTotal(stats.insertComparisonHist) != stats.inserts)
+		check::mismatch("AVLStats::insertComparisonHist total", "", histTotal(stats.insertComparisonHist), stats.inserts);
+	if (histTotal(stats.depthHist) != stats.inserts)
+		check::mismatch("AVLStats::depthHist total", "", histTotal(stats.depthHist), stats.inserts);
+	if (histTotal(stats.insertLatencyHist) != stats.inserts)
+		check::mismatch("AVLStats::insertLatencyHist total", "", histTotal(stats.insertLatencyHist), stats.inserts);
+	if (histTotal(stats.rangeComparisonHist) != stats.ranges)
+		check::mismatch("AVLStats::rangeComparisonHist total", "", histTotal(stats.rangeComparisonHist), stats.ranges);
+	if (histTotal(stats.rangeLatencyHist) != stats.ranges)
+		check::mismatch("AVLStats::rangeLatencyHist total", "", histTotal(stats.rangeLatencyHist), stats.ranges);
+	if (stats.rotationsLL + stats.rotationsLR + stats.rotationsRR + stats.rotationsRL == 0)
+		check::mismatch("AVLStats rotations on sorted input", "", 0, 1);
+	if (stats.insertComparisons == 0 || stats.rangeComparisons == 0)
+		check::mismatch("AVLStats comparisons", "", 0, 1);
+	// an AVL tree of n keys is at most 1.44 log2(n + 2) levels high
+	long long maxDepth = (long long)(1.44 * log2(n + 2.0));
+	if ((long long)stats.maxDepth > maxDepth)
+		check::mismatch("AVLStats::maxDepth", "", stats.maxDepth, maxDepth);
+
+	tree.resetStats();
+	stats = tree.stats();
+	if (stats.inserts || stats.ranges || stats.allocations || histTotal(stats.depthHist))
+		check::mismatch("AVL::resetStats", "", stats.inserts + stats.ranges + stats.allocations, 0);
+}
+#endif
+
+int main(int argc, char** argv)
+{
+	mt19937_64 rng = check::start(argc, argv);
+
+	checkWords(rng);
+	checkWeighted(rng);
+	checkTransparent(rng);
+	checkReversed(rng);
+	checkFailedInserts(rng);
+#ifdef AVL_STATS
+	checkStats(rng);
+#endif
+
+	return check::finish("rangecheck");
+}
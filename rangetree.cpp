@@ -0,0 +1,20 @@
+// Filename: rangetree.cpp
+//
+// Compiles the common instantiations of the (key, timestamp) range trees (see rangetree.h and rangetree.tpp) once
+//
+
+#include "rangetree.h"
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+namespace rangetree
+{
+
+template class StaticRangeTree2D<string>; // word keys, 64-bit timestamps
+template class StaticRangeTree2D<uint64_t>; // integer keys, 64-bit timestamps
+template class RangeTree2D<string>;
+template class RangeTree2D<uint64_t>;
+
+} // namespace rangetree
@@ -0,0 +1,91 @@
+#pragma once
+// Filename: rangetree.h
+//
+// Header file for two dimensional range counting over (key, timestamp) points: "how many keys in [str1, str2] were
+// inserted during [t1, t2]". StaticRangeTree2D is bulk built and answers a query in O(log^2 n); RangeTree2D accepts
+// inserts by keeping O(log n) static trees of doubling sizes (amortized O(log^2 n) insert, O(log^3 n) query).
+// The insert bound is only amortized: an insert that carries through every full slot rebuilds all n points, a single
+// O(n log n) pause (e.g. the insert that brings the tree to 2^k points). Member definitions live in rangetree.tpp
+//
+
+#ifndef RANGETREE_H
+#define RANGETREE_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace rangetree
+{
+
+template <class Key, class Time, class Compare> class RangeTree2D;
+
+// bulk built range tree: keys sorted by Compare, and above them a merge sort tree of timestamps where level l holds
+// the timestamps sorted inside every aligned block of 2^l keys
+template <class Key, class Time = uint64_t, class Compare = less<Key> >
+class StaticRangeTree2D
+{
+private:
+	vector<Key> keys; // keys in Compare order
+	vector<vector<Time> > levels; // levels[0] is the timestamps in key order, levels[l] sorts each block of 2^l
+	Compare comp; // key order
+
+	void buildSorted(vector<pair<Key, Time> >&); // build from points already sorted by key, moving their keys in
+	void takePoints(vector<pair<Key, Time> >&); // move every point out, in key order, leaving the tree empty
+	int countBlock(size_t, size_t, const Time&, const Time&) const; // timestamps in [t1, t2] inside one block
+
+	friend class RangeTree2D<Key, Time, Compare>;
+public:
+	explicit StaticRangeTree2D(const Compare& = Compare()); // empty tree
+	StaticRangeTree2D(vector<pair<Key, Time> >, const Compare& = Compare()); // bulk build from points
+
+	void build(vector<pair<Key, Time> >); // replace the contents with points, in any order
+	void points(vector<pair<Key, Time> >&) const; // append every point, in key order
+	void clear(); // remove every point
+	int size() const; // number of points
+
+	int count(const Key&, const Key&, const Time&, const Time&) const; // points with key in [str1, str2] and time in [t1, t2]
+};
+
+// dynamic range tree: slot i is empty or a static tree of exactly 2^i points, inserting works like a binary counter
+template <class Key, class Time = uint64_t, class Compare = less<Key> >
+class RangeTree2D
+{
+private:
+	vector<StaticRangeTree2D<Key, Time, Compare> > slots; // static trees of doubling sizes
+	Compare comp; // key order
+	int total; // number of points
+	uint64_t sequence; // next insertion sequence number handed out by insert(key)
+
+	void merge(vector<pair<Key, Time> >&, StaticRangeTree2D<Key, Time, Compare>&); // move a slot's points into sorted points
+public:
+	explicit RangeTree2D(const Compare& = Compare()); // empty tree
+
+	void insert(const Key&, const Time&); // insert key with an explicit timestamp
+	Time insert(const Key&); // insert key stamped with its insertion sequence number (0, 1, 2, ...), returns the stamp
+	void clear(); // remove every point
+	int size() const; // number of points
+
+	int count(const Key&, const Key&, const Time&, const Time&) const; // points with key in [str1, str2] and time in [t1, t2]
+};
+
+} // namespace rangetree
+
+#include "rangetree.tpp"
+
+namespace rangetree
+{
+
+// common instantiations are compiled once in rangetree.cpp
+extern template class StaticRangeTree2D<string>;
+extern template class StaticRangeTree2D<uint64_t>;
+extern template class RangeTree2D<string>;
+extern template class RangeTree2D<uint64_t>;
+
+} // namespace rangetree
+
+#endif
@@ -0,0 +1,241 @@
+// Filename: rangetree.tpp
+//
+// Contains the member definitions of StaticRangeTree2D and RangeTree2D, the (key, timestamp) range counting trees.
+// Included at the bottom of rangetree.h
+//
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace rangetree
+{
+
+#define RT_TEMPLATE template <class Key, class Time, class Compare>
+#define STATIC_CLASS StaticRangeTree2D<Key, Time, Compare>
+#define DYNAMIC_CLASS RangeTree2D<Key, Time, Compare>
+
+// Constructor for an empty tree ordered by cmp
+RT_TEMPLATE
+STATIC_CLASS::StaticRangeTree2D(const Compare& cmp)
+	: comp(cmp)
+{
+}
+
+// Constructor that bulk builds the tree from points
+RT_TEMPLATE
+STATIC_CLASS::StaticRangeTree2D(vector<pair<Key, Time> > pts, const Compare& cmp)
+	: comp(cmp)
+{
+	build(std::move(pts));
+}
+
+// build(points): replaces the contents of the tree with points, sorting them by key first
+// Input: (key, timestamp) points in any order
+// Output: Void
+RT_TEMPLATE
+void STATIC_CLASS::build(vector<pair<Key, Time> > pts)
+{
+	const Compare& order = comp;
+	stable_sort(pts.begin(), pts.end(), [&order](const pair<Key, Time>& a, const pair<Key, Time>& b) {
+		return order(a.first, b.first);
+	});
+	buildSorted(pts);
+}
+
+// buildSorted(points): builds the tree from points sorted by key. Level l is made by merging the sorted blocks of
+// level l - 1 pairwise, so the whole build is O(n log n). The keys are moved out of points
+RT_TEMPLATE
+void STATIC_CLASS::buildSorted(vector<pair<Key, Time> >& pts)
+{
+	size_t n = pts.size();
+	keys.clear();
+	levels.clear();
+	keys.reserve(n);
+	if (n == 0) // nothing to index
+		return;
+
+	levels.push_back(vector<Time>());
+	levels[0].reserve(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		keys.push_back(std::move(pts[i].first));
+		levels[0].push_back(pts[i].second);
+	}
+
+	// only blocks of 2^l <= n are ever used by count()
+	for (size_t l = 1; ((size_t)1 << l) <= n; l++)
+	{
+		const vector<Time>& below = levels[l - 1];
+		vector<Time> level(n);
+		size_t half = (size_t)1 << (l - 1);
+		for (size_t start = 0; start < n; start += 2 * half)
+		{
+			size_t mid = min(start + half, n), end = min(start + 2 * half, n);
+			std::merge(below.begin() + start, below.begin() + mid, below.begin() + mid, below.begin() + end, level.begin() + start);
+		}
+		levels.push_back(std::move(level));
+	}
+}
+
+// appends every point to out, in key order
+RT_TEMPLATE
+void STATIC_CLASS::points(vector<pair<Key, Time> >& out) const
+{
+	for (size_t i = 0; i < keys.size(); i++)
+		out.push_back(make_pair(keys[i], levels[0][i]));
+}
+
+// moves every point to out, in key order, and leaves the tree empty
+RT_TEMPLATE
+void STATIC_CLASS::takePoints(vector<pair<Key, Time> >& out)
+{
+	out.reserve(out.size() + keys.size());
+	for (size_t i = 0; i < keys.size(); i++)
+		out.push_back(make_pair(std::move(keys[i]), levels[0][i]));
+	clear();
+}
+
+// removes every point and releases the memory
+RT_TEMPLATE
+void STATIC_CLASS::clear()
+{
+	vector<Key>().swap(keys);
+	vector<vector<Time> >().swap(levels);
+}
+
+// returns number of points
+RT_TEMPLATE
+int STATIC_CLASS::size() const
+{
+	return (int)keys.size();
+}
+
+// counts the timestamps in [t1, t2] inside block number block of level l
+RT_TEMPLATE
+int STATIC_CLASS::countBlock(size_t l, size_t block, const Time& t1, const Time& t2) const
+{
+	typename vector<Time>::const_iterator first = levels[l].begin() + (block << l);
+	typename vector<Time>::const_iterator last = first + ((size_t)1 << l);
+	return (int)(upper_bound(first, last, t2) - lower_bound(first, last, t1));
+}
+
+// count(str1, str2, t1, t2): finds the keys in [str1, str2] with two binary searches, then covers that index range
+// with O(log n) aligned blocks (bottom up, like a segment tree) and binary searches the timestamps of each block
+// Input: key bounds and time bounds, both inclusive
+// Output: number of points inside the rectangle
+RT_TEMPLATE
+int STATIC_CLASS::count(const Key& str1, const Key& str2, const Time& t1, const Time& t2) const
+{
+	if (keys.empty() || comp(str2, str1) || t2 < t1) // empty tree or empty rectangle
+		return 0;
+
+	size_t low = lower_bound(keys.begin(), keys.end(), str1, comp) - keys.begin();
+	size_t high = upper_bound(keys.begin(), keys.end(), str2, comp) - keys.begin();
+
+	// [low, high) at level l is always [low << l, high << l) in key order, so every block taken is a full block
+	int total = 0;
+	for (size_t l = 0; low < high; l++)
+	{
+		if (low & 1) // low is a right child, take it and move past it
+			total += countBlock(l, low++, t1, t2);
+		if (high & 1) // high - 1 is a left child, take it
+			total += countBlock(l, --high, t1, t2);
+		low >>= 1;
+		high >>= 1;
+	}
+	return total;
+}
+
+// Constructor for an empty tree ordered by cmp
+RT_TEMPLATE
+DYNAMIC_CLASS::RangeTree2D(const Compare& cmp)
+	: comp(cmp), total(0), sequence(0)
+{
+}
+
+// moves the points of slot into pts, both sorted by key, keeping pts sorted. slot is left empty
+RT_TEMPLATE
+void DYNAMIC_CLASS::merge(vector<pair<Key, Time> >& pts, StaticRangeTree2D<Key, Time, Compare>& slot)
+{
+	vector<pair<Key, Time> > other;
+	slot.takePoints(other);
+	vector<pair<Key, Time> > merged;
+	merged.reserve(pts.size() + other.size());
+	const Compare& order = comp;
+	std::merge(make_move_iterator(other.begin()), make_move_iterator(other.end()),
+		make_move_iterator(pts.begin()), make_move_iterator(pts.end()), back_inserter(merged),
+		[&order](const pair<Key, Time>& a, const pair<Key, Time>& b) {
+			return order(a.first, b.first);
+		});
+	pts.swap(merged);
+}
+
+// insert(key, time): adds one point. Like incrementing a binary counter, the new point carries every full slot
+// from the bottom up into the first empty slot, which is rebuilt from the merged points. Filling slot i costs
+// O(2^i i), so most inserts are cheap but one that cascades into the top slot rebuilds every point in O(n log n)
+// Input: key and its timestamp
+// Output: Void
+RT_TEMPLATE
+void DYNAMIC_CLASS::insert(const Key& key, const Time& time)
+{
+	vector<pair<Key, Time> > carry;
+	carry.push_back(make_pair(key, time)); // the only copy of key
+	size_t i = 0;
+	for (; i < slots.size() && slots[i].size() > 0; i++)
+	{
+		merge(carry, slots[i]); // empties slot i
+	}
+	if (i == slots.size()) // every slot was full, grow by one
+		slots.push_back(StaticRangeTree2D<Key, Time, Compare>(comp));
+	slots[i].buildSorted(carry);
+	total++;
+}
+
+// insert(key): adds key stamped with its insertion sequence number
+// Input: key
+// Output: the timestamp given to key
+RT_TEMPLATE
+Time DYNAMIC_CLASS::insert(const Key& key)
+{
+	Time time = Time(sequence++);
+	insert(key, time);
+	return time;
+}
+
+// removes every point, the insertion sequence starts over
+RT_TEMPLATE
+void DYNAMIC_CLASS::clear()
+{
+	slots.clear();
+	total = 0;
+	sequence = 0;
+}
+
+// returns number of points
+RT_TEMPLATE
+int DYNAMIC_CLASS::size() const
+{
+	return total;
+}
+
+// count(str1, str2, t1, t2): sums the counts of every non-empty slot
+// Input: key bounds and time bounds, both inclusive
+// Output: number of points inside the rectangle
+RT_TEMPLATE
+int DYNAMIC_CLASS::count(const Key& str1, const Key& str2, const Time& t1, const Time& t2) const
+{
+	int found = 0;
+	for (size_t i = 0; i < slots.size(); i++)
+		found += slots[i].count(str1, str2, t1, t2);
+	return found;
+}
+
+#undef DYNAMIC_CLASS
+#undef STATIC_CLASS
+#undef RT_TEMPLATE
+
+} // namespace rangetree
@@ -0,0 +1,123 @@
+// Filename: rangetreecheck.cpp
+//
+// Brute force check of the (key, timestamp) range trees: random inserts into RangeTree2D interleaved with random
+// rectangle queries, every answer of RangeTree2D::count and of a StaticRangeTree2D bulk built from the same points is
+// compared against a scan of the inserted points. Registered with ctest.
+// Usage: rangetreecheck [seed]   (exit code 1 on any mismatch)
+//
+
+#include "check.h"
+#include "rangetree.h"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// "[str1, str2] x [t1, t2]" for a mismatch report
+template <class Key>
+static string rectangle(const Key& str1, const Key& str2, uint64_t t1, uint64_t t2)
+{
+	return check::interval(str1, str2) + " x " + check::interval(t1, t2);
+}
+
+// string keys stamped with their insertion sequence number
+static void checkWords(mt19937_64& rng)
+{
+	rangetree::RangeTree2D<string> tree;
+	vector<pair<string, uint64_t> > points;
+
+	for (int op = 0; op < 6000; op++)
+	{
+		if (rng() % 2 == 0) // insert
+		{
+			string word = check::randomWord(rng, 3, 6);
+			uint64_t time = tree.insert(word);
+			if (time != points.size())
+				check::mismatch("RangeTree2D<string>::insert stamp", word, time, points.size());
+			points.push_back(make_pair(word, time));
+			continue;
+		}
+
+		string str1 = check::randomWord(rng, 3, 6), str2 = check::randomWord(rng, 3, 6);
+		if (rng() % 8 != 0 && str2 < str1) // mostly proper rectangles, sometimes empty ones
+			swap(str1, str2);
+		uint64_t t1 = rng() % (points.size() + 2), t2 = rng() % (points.size() + 2);
+		if (rng() % 8 != 0 && t2 < t1)
+			swap(t1, t2);
+
+		long long want = 0;
+		for (size_t i = 0; i < points.size(); i++)
+			if (points[i].first >= str1 && points[i].first <= str2 && points[i].second >= t1 && points[i].second <= t2)
+				want++;
+
+		long long got = tree.count(str1, str2, t1, t2);
+		if (got != want)
+			check::mismatch("RangeTree2D<string>::count", rectangle(str1, str2, t1, t2), got, want);
+		if (op % 50 == 1) // bulk builds are O(n log n), only check some of the queries
+		{
+			rangetree::StaticRangeTree2D<string> bulk(points);
+			got = bulk.count(str1, str2, t1, t2);
+			if (got != want)
+				check::mismatch("StaticRangeTree2D<string>::count", rectangle(str1, str2, t1, t2), got, want);
+		}
+	}
+	if (tree.size() != (int)points.size())
+		check::mismatch("RangeTree2D<string>::size", "", tree.size(), points.size());
+}
+
+// integer keys with explicit, repeating and out of order timestamps
+static void checkIds(mt19937_64& rng)
+{
+	rangetree::RangeTree2D<uint64_t> tree;
+	vector<pair<uint64_t, uint64_t> > points;
+
+	for (int op = 0; op < 6000; op++)
+	{
+		if (rng() % 2 == 0) // insert
+		{
+			uint64_t key = rng() % 500, time = rng() % 300;
+			tree.insert(key, time);
+			points.push_back(make_pair(key, time));
+			continue;
+		}
+
+		uint64_t low = rng() % 520, high = rng() % 520, t1 = rng() % 320, t2 = rng() % 320;
+		if (rng() % 8 != 0 && high < low)
+			swap(low, high);
+		if (rng() % 8 != 0 && t2 < t1)
+			swap(t1, t2);
+
+		long long want = 0;
+		for (size_t i = 0; i < points.size(); i++)
+			if (points[i].first >= low && points[i].first <= high && points[i].second >= t1 && points[i].second <= t2)
+				want++;
+
+		long long got = tree.count(low, high, t1, t2);
+		if (got != want)
+			check::mismatch("RangeTree2D<uint64_t>::count", rectangle(low, high, t1, t2), got, want);
+		if (op % 50 == 1)
+		{
+			rangetree::StaticRangeTree2D<uint64_t> bulk(points);
+			got = bulk.count(low, high, t1, t2);
+			if (got != want)
+				check::mismatch("StaticRangeTree2D<uint64_t>::count", rectangle(low, high, t1, t2), got, want);
+		}
+	}
+
+	tree.clear();
+	if (tree.size() != 0 || tree.count(0, 1000, 0, 1000) != 0)
+		check::mismatch("RangeTree2D<uint64_t>::clear", "", tree.size() + tree.count(0, 1000, 0, 1000), 0);
+}
+
+int main(int argc, char** argv)
+{
+	mt19937_64 rng = check::start(argc, argv);
+
+	checkWords(rng);
+	checkIds(rng);
+
+	return check::finish("rangetreecheck");
+}
@@ -0,0 +1,377 @@
+// Filename: servercheck.cpp
+//
+// End to end check of wordrange_server: starts the server on a temporary socket with a preload file, pipelines a
+// burst of inserts and ranges whose responses are larger than the server's output limit before reading any of them,
+// half-closes, and compares every response against a brute force count. Also runs concurrent pipelining clients,
+// sends malformed requests, and checks that the server refuses to replace a regular file or a live socket at its
+// path. Linux only. Registered with ctest.
+// Usage: servercheck <wordrange_server binary> [seed]   (exit code 1 on any mismatch)
+//
+
+#include "check.h"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const size_t BURST = 200000; // requests in the pipelined burst, their responses are well over 1 MB
+static const int CLIENTS = 4; // concurrent pipelining clients
+static const size_t CLIENT_REQUESTS = 2000; // range requests per concurrent client
+
+typedef map<string, long long> WordCounts; // how often each word was inserted
+
+// one encoded request, see the protocol at the top of wordrange_server.cpp
+static string encode(char op, const string& str1, const string& str2)
+{
+	string request(1, op);
+	request += (char)(str1.size() & 0xff);
+	request += (char)(str1.size() >> 8);
+	request += (char)(str2.size() & 0xff);
+	request += (char)(str2.size() >> 8);
+	return request + str1 + str2;
+}
+
+static uint64_t readU64(const char* p)
+{
+	uint64_t value = 0;
+	for (int i = 7; i >= 0; i--)
+		value = (value << 8) | (unsigned char)p[i];
+	return value;
+}
+
+// connects to the server at path, reads time out so a hung server fails the check instead of blocking it
+static int connectTo(const string& path)
+{
+	sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		return -1;
+	if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0)
+	{
+		close(fd);
+		return -1;
+	}
+	timeval timeout = { 30, 0 };
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	return fd;
+}
+
+static bool sendAll(int fd, const string& data)
+{
+	for (size_t sent = 0; sent < data.size(); )
+	{
+		ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+		sent += n;
+	}
+	return true;
+}
+
+// reads exactly size bytes, returns false on end of stream, error or timeout
+static bool recvAll(int fd, string& data, size_t size)
+{
+	data.resize(size);
+	for (size_t got = 0; got < size; )
+	{
+		ssize_t n = recv(fd, &data[got], size - got, 0);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+		got += n;
+	}
+	return true;
+}
+
+// true if the server closed the connection without sending anything more
+static bool closedByPeer(int fd)
+{
+	char byte;
+	ssize_t n;
+	while ((n = recv(fd, &byte, 1, 0)) < 0 && errno == EINTR)
+		;
+	return n == 0;
+}
+
+// brute force count of the inserted words in [str1, str2]
+static long long bruteCount(const WordCounts& counts, const string& str1, const string& str2)
+{
+	long long total = 0;
+	for (WordCounts::const_iterator it = counts.begin(); it != counts.end(); ++it)
+		if (it->first >= str1 && it->first <= str2)
+			total += it->second;
+	return total;
+}
+
+// forks and execs the server, its own messages go to stderr
+static pid_t startServer(const char* binary, const string& path, const string& input)
+{
+	pid_t pid = fork();
+	if (pid == 0)
+	{
+		execl(binary, binary, path.c_str(), input.empty() ? NULL : input.c_str(), (char*)NULL);
+		perror(binary);
+		_exit(127);
+	}
+	return pid;
+}
+
+// waits until the server accepts connections, returns false if it exited or did not come up in time
+static bool waitForServer(pid_t pid, const string& path)
+{
+	for (int attempt = 0; attempt < 500; attempt++)
+	{
+		int fd = connectTo(path);
+		if (fd >= 0)
+		{
+			close(fd);
+			return true;
+		}
+		if (waitpid(pid, NULL, WNOHANG) == pid)
+			return false;
+		this_thread::sleep_for(chrono::milliseconds(10));
+	}
+	return false;
+}
+
+// runs a server that is expected to refuse to start, returns its exit status
+static int refusedStart(const char* binary, const string& path)
+{
+	pid_t pid = startServer(binary, path, "");
+	int status = 0;
+	waitpid(pid, &status, 0);
+	return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+// one connection pipelines a mix of inserts and ranges without reading, so the server's output backs up past its
+// limit and it has to throttle the connection, then half-closes and reads every response
+static void checkBurst(mt19937_64& rng, const string& path, WordCounts& counts, long long& size)
+{
+	string requests;
+	vector<uint64_t> want;
+	want.reserve(BURST);
+	for (size_t r = 0; r < BURST; r++)
+	{
+		if (rng() % 3 == 0) // insert, answered with the tree size
+		{
+			string word = check::randomWord(rng, 3, 6);
+			requests += encode('i', word, "");
+			counts[word]++;
+			want.push_back(++size);
+			continue;
+		}
+		string str1 = check::randomWord(rng, 3, 6), str2 = check::randomWord(rng, 3, 6);
+		if (rng() % 8 != 0 && str2 < str1) // mostly proper ranges, sometimes empty ones
+			swap(str1, str2);
+		requests += encode('r', str1, str2);
+		want.push_back(bruteCount(counts, str1, str2));
+	}
+
+	int fd = connectTo(path);
+	if (fd < 0)
+	{
+		check::mismatch("burst connect", path, -1, 0);
+		return;
+	}
+
+	// the sender blocks once the server stops reading, which only resumes when the responses are read below
+	bool sent = false;
+	thread sender([fd, &requests, &sent]() {
+		sent = sendAll(fd, requests);
+		shutdown(fd, SHUT_WR); // half-close, the server must still answer everything it received
+	});
+	this_thread::sleep_for(chrono::milliseconds(200));
+
+	string responses;
+	bool received = recvAll(fd, responses, want.size() * 8);
+	sender.join();
+	if (!sent)
+		check::mismatch("burst send", "", 0, 1);
+	if (!received)
+		check::mismatch("burst responses", "", 0, 1);
+	else
+		for (size_t r = 0; r < want.size(); r++)
+		{
+			long long got = (long long)readU64(responses.data() + 8 * r);
+			if (got != (long long)want[r])
+				check::mismatch("burst response", "#" + to_string(r), got, (long long)want[r]);
+		}
+	if (!closedByPeer(fd))
+		check::mismatch("burst close after half-close", "", 0, 1);
+	close(fd);
+}
+
+// several clients pipeline ranges at the same time, answers must match the final word counts
+static void checkConcurrent(mt19937_64& rng, const string& path, const WordCounts& counts)
+{
+	vector<string> requests(CLIENTS);
+	vector<vector<uint64_t> > want(CLIENTS);
+	for (int c = 0; c < CLIENTS; c++)
+		for (size_t r = 0; r < CLIENT_REQUESTS; r++)
+		{
+			string str1 = check::randomWord(rng, 3, 6), str2 = check::randomWord(rng, 3, 6);
+			if (str2 < str1)
+				swap(str1, str2);
+			requests[c] += encode('r', str1, str2);
+			want[c].push_back(bruteCount(counts, str1, str2));
+		}
+
+	vector<string> responses(CLIENTS);
+	vector<int> ok(CLIENTS, 0);
+	vector<thread> clients;
+	for (int c = 0; c < CLIENTS; c++)
+		clients.push_back(thread([c, &path, &requests, &responses, &ok]() {
+			int fd = connectTo(path);
+			if (fd < 0)
+				return;
+			ok[c] = sendAll(fd, requests[c]) && recvAll(fd, responses[c], CLIENT_REQUESTS * 8);
+			close(fd);
+		}));
+	for (size_t c = 0; c < clients.size(); c++)
+		clients[c].join();
+
+	for (int c = 0; c < CLIENTS; c++)
+	{
+		if (!ok[c])
+		{
+			check::mismatch("concurrent client", to_string(c), 0, 1);
+			continue;
+		}
+		for (size_t r = 0; r < CLIENT_REQUESTS; r++)
+		{
+			long long got = (long long)readU64(responses[c].data() + 8 * r);
+			if (got != (long long)want[c][r])
+				check::mismatch("concurrent response", to_string(c) + " #" + to_string(r), got, (long long)want[c][r]);
+		}
+	}
+}
+
+// malformed requests close their connection, after answering the complete requests sent before them
+static void checkMalformed(const string& path, long long size)
+{
+	int fd = connectTo(path);
+	string response;
+	if (fd < 0 || !sendAll(fd, encode('r', "a", "zzz") + encode('x', "a", "b")))
+		check::mismatch("malformed op send", "", 0, 1);
+	else
+	{
+		if (!recvAll(fd, response, 8) || (long long)readU64(response.data()) != size)
+			check::mismatch("response before malformed op", "", response.size() == 8 ? (long long)readU64(response.data()) : -1, size);
+		if (!closedByPeer(fd))
+			check::mismatch("malformed op closes", "", 0, 1);
+	}
+	if (fd >= 0)
+		close(fd);
+
+	fd = connectTo(path);
+	if (fd < 0 || !sendAll(fd, encode('i', "a", "b"))) // inserts take one string
+		check::mismatch("malformed insert send", "", 0, 1);
+	else if (!closedByPeer(fd))
+		check::mismatch("malformed insert closes", "", 0, 1);
+	if (fd >= 0)
+		close(fd);
+
+	// other connections are unaffected
+	fd = connectTo(path);
+	if (fd < 0 || !sendAll(fd, encode('r', "a", "zzz")) || !recvAll(fd, response, 8))
+		check::mismatch("request after malformed ones", "", 0, 1);
+	else if ((long long)readU64(response.data()) != size)
+		check::mismatch("request after malformed ones", "", (long long)readU64(response.data()), size);
+	if (fd >= 0)
+		close(fd);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: %s <wordrange_server binary> [seed]\n", argv[0]);
+		return 1;
+	}
+	const char* binary = argv[1];
+	mt19937_64 rng = check::start(argc - 1, argv + 1);
+
+	char dirTemplate[] = "/tmp/servercheck.XXXXXX";
+	if (!mkdtemp(dirTemplate))
+	{
+		perror("mkdtemp");
+		return 1;
+	}
+	string dir = dirTemplate, path = dir + "/wordrange.sock", input = dir + "/input.txt";
+
+	// preload file, its "r" lines are ignored
+	WordCounts counts;
+	long long size = 0;
+	{
+		ofstream out(input.c_str());
+		for (int i = 0; i < 50; i++)
+		{
+			string word = check::randomWord(rng, 3, 6);
+			out << "i " << word << "\n";
+			counts[word]++;
+			size++;
+		}
+		out << "r a f\n";
+	}
+
+	// a regular file at the socket path is neither deleted nor replaced
+	if (refusedStart(binary, input) == 0)
+		check::mismatch("server started on a regular file", input, 0, 1);
+	struct stat info;
+	if (stat(input.c_str(), &info) < 0)
+		check::mismatch("regular file at the socket path kept", input, 0, 1);
+
+	pid_t server = startServer(binary, path, input);
+	if (!waitForServer(server, path))
+	{
+		check::mismatch("server start", path, 0, 1);
+		unlink(input.c_str());
+		rmdir(dir.c_str());
+		return check::finish("servercheck");
+	}
+
+	// a second server on the live socket refuses to start
+	if (refusedStart(binary, path) == 0)
+		check::mismatch("second server on a live socket", path, 0, 1);
+
+	checkBurst(rng, path, counts, size);
+	checkConcurrent(rng, path, counts);
+	checkMalformed(path, size);
+
+	// SIGTERM stops the server cleanly and removes its socket
+	kill(server, SIGTERM);
+	int status = 0;
+	waitpid(server, &status, 0);
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		check::mismatch("server exit status", "", WIFEXITED(status) ? WEXITSTATUS(status) : -1, 0);
+	if (lstat(path.c_str(), &info) == 0)
+		check::mismatch("socket removed on exit", path, 1, 0);
+
+	unlink(path.c_str());
+	unlink(input.c_str());
+	rmdir(dir.c_str());
+	return check::finish("servercheck");
+}
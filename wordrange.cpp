@@ -24,7 +24,7 @@ int main()
 	input.open("input.txt"); // open input file
 	output.open("output.txt"); // open output file
 
-	AVL myAVL;
+	avl::AVL<string> myAVL;
 
 	string line;
 	while (getline(input, line))
@@ -45,4 +45,10 @@ int main()
 	}
 	input.close();
 	output.close();
+
+#ifdef AVL_STATS
+	ofstream stats("stats.json"); // instrumented builds also dump their counters
+	stats << myAVL.stats().toJSON();
+	stats.close();
+#endif
 }
@@ -0,0 +1,444 @@
+// Filename: wordrange_server.cpp
+//
+// Resident version of wordrange: keeps the AVL tree in memory and answers i/r commands over a Unix domain socket,
+// so callers no longer rebuild the tree from input.txt for every job. Linux only (epoll).
+//
+// Usage: wordrange_server <socket path> [input file]
+// The optional input file uses the input.txt format, its "i" lines are inserted before the server starts listening.
+// A socket left at the path by an earlier run is replaced; a regular file, or a socket another server still accepts
+// on, makes the server refuse to start.
+//
+// Protocol, all integers little endian. Clients may pipeline any number of requests on a connection.
+//   request:  op (1 byte, 'i' or 'r'), len1 (2 bytes), len2 (2 bytes), str1 (len1 bytes), str2 (len2 bytes)
+//             'i' inserts str1 (len2 must be 0), 'r' counts the strings between str1 and str2
+//   response: one 8 byte unsigned integer per request, in request order: the tree size after an 'i', the count for an 'r'
+// A malformed request closes the connection once the requests before it are answered.
+//
+// Every wakeup of the event loop first reads all readable connections, then applies the complete requests of all of
+// them to the tree as one batch, then flushes the responses. Concurrent bursts are coalesced into a single pass over
+// the tree and a single write per connection.
+//
+// Backpressure: a connection reads at most MAX_READ_PER_WAKEUP bytes per wakeup, and once MAX_PENDING_OUTPUT bytes of
+// its responses are unwritten its requests are no longer parsed and it stops being polled for input, until the client
+// reads enough of them. If accept() fails for lack of file descriptors or memory the listener is paused until a
+// connection closes or ACCEPT_RETRY_MS has passed.
+//
+
+#include "avl.h"
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+// string keys with transparent comparison, so range bounds can be string_views into the read buffer
+typedef avl::AVL<string, avl::NoValue, less<> > WordTree;
+
+static const size_t HEADER_SIZE = 5; // op, len1, len2
+static const size_t READ_CHUNK = 64 * 1024;
+static const size_t MAX_READ_PER_WAKEUP = 4 * READ_CHUNK; // so one busy client cannot stall the others
+static const size_t MAX_PENDING_OUTPUT = 1024 * 1024; // unwritten response bytes before a connection is throttled
+static const size_t RESPONSE_SIZE = 8;
+static const int MAX_EVENTS = 256;
+static const int ACCEPT_RETRY_MS = 1000;
+
+static volatile sig_atomic_t stopping = 0;
+
+// one client connection
+struct Conn
+{
+	int fd;
+	string in; // bytes read but not yet parsed
+	size_t inPos; // start of the first unparsed request in 'in'
+	string out; // responses not yet written
+	size_t outPos; // start of the unwritten part of 'out'
+	uint32_t armed; // epoll events currently registered
+	bool eof; // peer finished sending or sent a malformed request, close once the responses are written
+	bool throttled; // parsing stopped at MAX_PENDING_OUTPUT, the rest of 'in' waits until the output drains
+	bool closed; // broken, freed after the current batch
+};
+
+// one parsed request, the strings point into its connection's read buffer
+struct Request
+{
+	Conn* conn;
+	char op;
+	string_view str1, str2;
+};
+
+static void onSignal(int)
+{
+	stopping = 1;
+}
+
+static uint16_t readU16(const char* p)
+{
+	return (uint16_t)((unsigned char)p[0] | ((unsigned char)p[1] << 8));
+}
+
+static void appendU64(string& out, uint64_t value)
+{
+	char bytes[8];
+	for (int i = 0; i < 8; i++)
+		bytes[i] = (char)(value >> (8 * i));
+	out.append(bytes, 8);
+}
+
+static bool setNonBlocking(int fd)
+{
+	int flags = fcntl(fd, F_GETFL, 0);
+	return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// inserts the "i" lines of an input.txt style file
+static void preload(WordTree& tree, const char* path)
+{
+	ifstream input(path);
+	string line;
+	while (getline(input, line))
+	{
+		istringstream ss(line);
+		string op, word;
+		if (ss >> op >> word && op == "i")
+			tree.insert(word);
+	}
+}
+
+// unwritten response bytes of conn
+static size_t backlog(const Conn* conn)
+{
+	return conn->out.size() - conn->outPos;
+}
+
+// reads what is available on conn, up to MAX_READ_PER_WAKEUP bytes (level triggered epoll reports the rest on the
+// next wakeup), returns false once the peer has gone away
+static bool readConn(Conn* conn)
+{
+	char chunk[READ_CHUNK];
+	for (size_t total = 0; total < MAX_READ_PER_WAKEUP; )
+	{
+		ssize_t got = recv(conn->fd, chunk, sizeof(chunk), 0);
+		if (got > 0)
+		{
+			conn->in.append(chunk, got);
+			total += got;
+		}
+		else if (got == 0) // orderly shutdown
+			return false;
+		else if (errno == EINTR)
+			continue;
+		else
+			return errno == EAGAIN || errno == EWOULDBLOCK;
+	}
+	return true;
+}
+
+// splits the complete requests at the front of conn's buffer into batch, as long as their responses fit under
+// MAX_PENDING_OUTPUT, returns false on a malformed request
+static bool parseConn(Conn* conn, vector<Request>& batch)
+{
+	size_t room = backlog(conn) < MAX_PENDING_OUTPUT ? (MAX_PENDING_OUTPUT - backlog(conn)) / RESPONSE_SIZE : 0;
+	conn->throttled = false;
+	while (conn->in.size() - conn->inPos >= HEADER_SIZE)
+	{
+		if (room == 0) // output is backed up, leave the rest in the buffer
+		{
+			conn->throttled = true;
+			break;
+		}
+		const char* p = conn->in.data() + conn->inPos;
+		char op = p[0];
+		size_t len1 = readU16(p + 1), len2 = readU16(p + 3);
+		if ((op != 'i' && op != 'r') || (op == 'i' && len2 != 0))
+			return false;
+		if (conn->in.size() - conn->inPos < HEADER_SIZE + len1 + len2) // rest has not arrived yet
+			break;
+		batch.push_back(Request{ conn, op, string_view(p + HEADER_SIZE, len1), string_view(p + HEADER_SIZE + len1, len2) });
+		conn->inPos += HEADER_SIZE + len1 + len2;
+		room--;
+	}
+	return true;
+}
+
+// writes as much pending output as the socket takes, returns false if the connection broke
+static bool flushConn(Conn* conn)
+{
+	while (conn->outPos < conn->out.size())
+	{
+		ssize_t sent = send(conn->fd, conn->out.data() + conn->outPos, conn->out.size() - conn->outPos, MSG_NOSIGNAL);
+		if (sent > 0)
+			conn->outPos += sent;
+		else if (sent < 0 && errno == EINTR)
+			continue;
+		else
+			return sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+	}
+	conn->out.clear();
+	conn->outPos = 0;
+	return true;
+}
+
+// starts or stops polling the listener, returns false if epoll refused
+static bool watchListener(int epoll, int listener, bool on)
+{
+	epoll_event event;
+	event.events = on ? (uint32_t)EPOLLIN : 0u;
+	event.data.ptr = NULL;
+	return epoll_ctl(epoll, EPOLL_CTL_MOD, listener, &event) == 0;
+}
+
+// removes a stale socket left at the path of addr by an earlier run. Anything that is not a socket, and a socket
+// another server still accepts on, is left alone and the server refuses to start
+static bool claimPath(const sockaddr_un& addr)
+{
+	const char* path = addr.sun_path;
+	struct stat info;
+	if (lstat(path, &info) < 0)
+	{
+		if (errno == ENOENT) // nothing there
+			return true;
+		perror(path);
+		return false;
+	}
+	if (!S_ISSOCK(info.st_mode))
+	{
+		fprintf(stderr, "%s exists and is not a socket, not replacing it\n", path);
+		return false;
+	}
+
+	int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (probe < 0)
+	{
+		perror("socket");
+		return false;
+	}
+	int connected = connect(probe, (const sockaddr*)&addr, sizeof(addr));
+	int error = errno;
+	close(probe);
+	if (connected == 0 || error != ECONNREFUSED) // a live server, or one too busy to tell
+	{
+		fprintf(stderr, "another server is listening on %s\n", path);
+		return false;
+	}
+	if (unlink(path) < 0)
+	{
+		perror(path);
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: %s <socket path> [input file]\n", argv[0]);
+		return 1;
+	}
+	const char* path = argv[1];
+
+	// listening socket
+	sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(addr.sun_path))
+	{
+		fprintf(stderr, "socket path too long: %s\n", path);
+		return 1;
+	}
+	strcpy(addr.sun_path, path);
+	if (!claimPath(addr))
+		return 1;
+
+	WordTree tree;
+	if (argc > 2)
+		preload(tree, argv[2]);
+
+	int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listener < 0 || bind(listener, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(listener, SOMAXCONN) < 0
+		|| !setNonBlocking(listener))
+	{
+		perror("listen");
+		return 1;
+	}
+
+	int epoll = epoll_create1(0);
+	epoll_event event;
+	event.events = EPOLLIN;
+	event.data.ptr = NULL; // the listener is the only entry without a Conn
+	if (epoll < 0 || epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &event) < 0)
+	{
+		perror("epoll");
+		return 1;
+	}
+
+	// stop cleanly on SIGINT/SIGTERM, epoll_wait returns EINTR since SA_RESTART is not set
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = onSignal;
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+
+	fprintf(stderr, "wordrange_server: %d words loaded, listening on %s\n", tree.size(), path);
+
+	unordered_map<int, Conn*> conns;
+	vector<Request> batch;
+	vector<Conn*> touched; // connections with events during this wakeup (epoll reports each one once)
+	epoll_event events[MAX_EVENTS];
+	bool accepting = true; // false while the listener is paused after accept() ran out of descriptors or memory
+
+	while (!stopping)
+	{
+		int ready = epoll_wait(epoll, events, MAX_EVENTS, accepting ? -1 : ACCEPT_RETRY_MS);
+		if (ready < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			perror("epoll_wait");
+			break;
+		}
+		if (!accepting && ready == 0) // retry timer expired, try accepting again
+			accepting = watchListener(epoll, listener, true);
+
+		batch.clear();
+		touched.clear();
+
+		// gather: accept new clients and parse every complete request that has arrived
+		for (int e = 0; e < ready; e++)
+		{
+			Conn* conn = (Conn*)events[e].data.ptr;
+			if (!conn) // new connections
+			{
+				while (true)
+				{
+					int fd = accept(listener, NULL, NULL);
+					if (fd < 0)
+					{
+						if (errno == EINTR || errno == ECONNABORTED) // transient, try the next one
+							continue;
+						if (errno == EAGAIN || errno == EWOULDBLOCK) // backlog drained
+							break;
+						// out of descriptors or memory (EMFILE, ENFILE, ENOBUFS, ENOMEM): the listener stays readable,
+						// so stop polling it until a connection closes or the retry timer expires instead of spinning
+						perror("accept");
+						if (watchListener(epoll, listener, false))
+							accepting = false;
+						break;
+					}
+					if (!setNonBlocking(fd))
+					{
+						perror("fcntl");
+						close(fd);
+						continue;
+					}
+					Conn* client = new Conn{ fd, string(), 0, string(), 0, EPOLLIN | EPOLLRDHUP, false, false, false };
+					epoll_event clientEvent;
+					clientEvent.events = client->armed;
+					clientEvent.data.ptr = client;
+					if (epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &clientEvent) < 0)
+					{
+						perror("epoll_ctl");
+						close(fd);
+						delete client;
+						continue;
+					}
+					conns[fd] = client;
+				}
+				continue;
+			}
+
+			// make room first, so a throttled connection can go on parsing in this same wakeup
+			if ((events[e].events & EPOLLOUT) && !flushConn(conn))
+				conn->closed = true;
+			if (events[e].events & EPOLLERR)
+				conn->closed = true;
+			if (!conn->closed)
+			{
+				if (!conn->eof && backlog(conn) < MAX_PENDING_OUTPUT && (events[e].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)))
+					if (!readConn(conn))
+						conn->eof = true;
+				if (!parseConn(conn, batch)) // answer what came before the malformed request, then close
+				{
+					conn->in.resize(conn->inPos);
+					conn->eof = true;
+				}
+			}
+			touched.push_back(conn);
+		}
+
+		// apply: one pass over the tree for the whole batch, in arrival order
+		for (size_t r = 0; r < batch.size(); r++)
+		{
+			Request& req = batch[r];
+			if (req.op == 'i')
+			{
+				tree.insert(string(req.str1));
+				appendU64(req.conn->out, tree.size());
+			}
+			else
+				appendU64(req.conn->out, tree.range(req.str1, req.str2));
+		}
+
+		// flush: one write per connection, drop the parsed input, and free closed connections
+		for (size_t c = 0; c < touched.size(); c++)
+		{
+			Conn* conn = touched[c];
+			if (!conn->closed)
+			{
+				conn->in.erase(0, conn->inPos);
+				conn->inPos = 0;
+				if (!flushConn(conn))
+					conn->closed = true;
+			}
+			bool pending = conn->outPos < conn->out.size();
+			if (conn->closed || (conn->eof && !pending && !conn->throttled))
+			{
+				epoll_ctl(epoll, EPOLL_CTL_DEL, conn->fd, NULL);
+				close(conn->fd);
+				conns.erase(conn->fd);
+				delete conn;
+				if (!accepting) // a descriptor was freed, try accepting again
+					accepting = watchListener(epoll, listener, true);
+				continue;
+			}
+
+			// read until the peer is done or the output backs up, wait for EPOLLOUT while output is pending. A throttled
+			// connection also waits for EPOLLOUT, which fires at once if the output already drained, to resume parsing
+			uint32_t wanted = (conn->eof || conn->throttled ? 0u : (uint32_t)(EPOLLIN | EPOLLRDHUP))
+				| (pending || conn->throttled ? (uint32_t)EPOLLOUT : 0u);
+			if (wanted != conn->armed)
+			{
+				epoll_event clientEvent;
+				clientEvent.events = wanted;
+				clientEvent.data.ptr = conn;
+				epoll_ctl(epoll, EPOLL_CTL_MOD, conn->fd, &clientEvent);
+				conn->armed = wanted;
+			}
+		}
+	}
+
+	for (unordered_map<int, Conn*>::iterator it = conns.begin(); it != conns.end(); ++it)
+	{
+		close(it->first);
+		delete it->second;
+	}
+	close(epoll);
+	close(listener);
+	unlink(path);
+	return 0;
+}